@@ -0,0 +1,188 @@
+#ifndef EXAMPLES_BUCKETED_QUEUE_WITH_MIN_HPP
+#define EXAMPLES_BUCKETED_QUEUE_WITH_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "queue_with_min_v2.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace examples_v2 {
+
+/**
+Approximate windowed min for very large horizons. Consecutive elements are folded into buckets of
+bucket_size() elements, only the min, the count and the timestamp span of each bucket are stored.
+Closed buckets live in a queue_with_min ordered by their mins, so min() is O(1) and the memory is
+O(horizon / bucket_size) instead of O(horizon).
+
+Elements expire by whole buckets, so min() may account up to error_bound() elements that are older
+than the exact window. The oldest accounted element has oldest_timestamp().
+
+T must be DefaultConstructible, CopyAssignable and LessThanComparable, pushed timestamps must not decrease.
+*/
+template <class T, class Timestamp = std::uint64_t>
+class bucketed_queue_with_min {
+public:
+    typedef T           value_type;
+    typedef Timestamp   timestamp_type;
+
+    /// Summary of bucket_size() or less consecutive elements.
+    struct bucket_type {
+        value_type      min;
+        std::size_t     count;
+        timestamp_type  first;  // timestamp of the oldest element
+        timestamp_type  last;   // timestamp of the newest element
+
+        friend bool operator<(const bucket_type& lhs, const bucket_type& rhs) {
+            return lhs.min < rhs.min;
+        }
+    };
+
+private:
+    std::size_t                     bucket_size_;
+    std::size_t                     horizon_;
+    std::size_t                     size_;
+    queue_with_min<bucket_type>     closed_;
+    bucket_type                     open_;      // valid if open_.count != 0
+
+    void pop_front_bucket() {
+        if (closed_.empty()) {
+            size_ -= open_.count;
+            open_.count = 0;
+            return;
+        }
+
+        size_ -= closed_.front().count;
+        closed_.pop_front();
+    }
+
+public:
+    /**
+    \param bucket_size Elements in each bucket.
+    \param horizon If not 0, push_back() expires the oldest buckets so that size() stays in [horizon, horizon + bucket_size).
+    \throws std::invalid_argument if bucket_size is 0.
+
+    \b Complexity: O(1)
+    */
+    explicit bucketed_queue_with_min(std::size_t bucket_size, std::size_t horizon = 0)
+        : bucket_size_(bucket_size)
+        , horizon_(horizon)
+        , size_(0)
+        , closed_()
+        , open_()
+    {
+        if (!bucket_size_) {
+            throw std::invalid_argument("examples_v2::bucketed_queue_with_min: bucket_size must be positive");
+        }
+    }
+
+    /// \b Complexity: amort O(1)
+    void push_back(const value_type& v, timestamp_type ts) {
+        assert(empty() || !(ts < back_timestamp()));
+
+        if (!open_.count) {
+            open_.min = v;
+            open_.first = ts;
+        } else if (v < open_.min) {
+            open_.min = v;
+        }
+        open_.last = ts;
+        ++ open_.count;
+        ++ size_;
+
+        if (open_.count == bucket_size_) {
+            closed_.push_back(open_);
+            open_.count = 0;
+        }
+
+        while (horizon_ && size_ - front_bucket().count >= horizon_) {
+            pop_front_bucket();
+        }
+    }
+
+    /// Expires the oldest bucket. \b Complexity: amort O(1)
+    void pop_front() {
+        assert(!empty());
+        pop_front_bucket();
+    }
+
+    /// Expires the buckets with all the elements older than `ts`. \b Complexity: amort O(expired buckets)
+    void expire_before(timestamp_type ts) {
+        while (!empty() && front_bucket().last < ts) {
+            pop_front_bucket();
+        }
+    }
+
+    /// Min of all the accounted elements. \b Complexity: O(1)
+    const value_type& min() const {
+        assert(!empty());
+
+        if (closed_.empty()) {
+            return open_.min;
+        }
+
+        const value_type& closed_min = closed_.min().min;
+        if (!open_.count) {
+            return closed_min;
+        }
+
+        return open_.min < closed_min ? open_.min : closed_min;
+    }
+
+    /// Oldest bucket. \b Complexity: O(1)
+    const bucket_type& front_bucket() const {
+        return closed_.empty() ? open_ : closed_.front();
+    }
+
+    /// Timestamp of the oldest accounted element. \b Complexity: O(1)
+    timestamp_type oldest_timestamp() const {
+        return front_bucket().first;
+    }
+
+    /// Timestamp of the newest element. \b Complexity: O(1)
+    timestamp_type back_timestamp() const {
+        return open_.count ? open_.last : closed_.back().last;
+    }
+
+    /// Max count of the accounted elements that would be expired in an exact window. \b Complexity: O(1)
+    std::size_t error_bound() const noexcept {
+        return bucket_size_ - 1;
+    }
+
+    /// \b Complexity: O(1)
+    std::size_t bucket_size() const noexcept {
+        return bucket_size_;
+    }
+
+    /// Count of the accounted elements. \b Complexity: O(1)
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    /// Count of the stored buckets, including the partially filled one. \b Complexity: O(1)
+    std::size_t buckets_count() const noexcept {
+        return closed_.size() + (open_.count ? 1 : 0);
+    }
+
+    /// \b Complexity: O(1)
+    bool empty() const noexcept {
+        return !size_;
+    }
+
+    /// \b Complexity: O(buckets_count())
+    void clear() noexcept {
+        closed_.clear();
+        open_.count = 0;
+        size_ = 0;
+    }
+};
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_BUCKETED_QUEUE_WITH_MIN_HPP
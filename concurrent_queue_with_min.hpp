@@ -0,0 +1,234 @@
+#ifndef EXAMPLES_CONCURRENT_QUEUE_WITH_MIN_HPP
+#define EXAMPLES_CONCURRENT_QUEUE_WITH_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "queue_with_min_v2.hpp"
+
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cassert>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#   include <coroutine>
+#   include <deque>
+#   include <optional>
+#   define EXAMPLES_QUEUE_WITH_MIN_HAS_COROUTINES
+#endif
+
+
+namespace examples_v2 {
+
+namespace detail {
+
+struct min_change_flag {
+    bool changed = false;
+
+    template <class T>
+    void operator()(const T& /*new_min*/) noexcept {
+        changed = true;
+    }
+};
+
+} // namespace detail
+
+/**
+Thread safe queue_with_min with blocking consumers. Consumers that wait for min() are woken up
+only when the min() actually changes, so there's no need to poll min() in a loop.
+
+Coroutines suspended in `co_await async_pop()` must be resumed or destroyed before the queue is destroyed.
+
+T must be CopyConstructible.
+*/
+template <class T>
+class concurrent_queue_with_min {
+    typedef queue_with_min<T, detail::min_change_flag> queue_t;
+
+    mutable std::mutex              mutex_;
+    std::condition_variable         not_empty_;
+    mutable std::condition_variable min_changed_;
+    queue_t                         queue_;
+
+    T pop_front_locked() {
+        T v = queue_.front();
+        queue_.pop_front();
+        return v;
+    }
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_COROUTINES
+public:
+    class pop_awaiter;
+
+private:
+    std::deque<pop_awaiter*> awaiters_;
+#endif
+
+public:
+    typedef T value_type;
+
+    concurrent_queue_with_min() = default;
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_COROUTINES
+    ~concurrent_queue_with_min() {
+        assert(awaiters_.empty());
+    }
+#endif
+
+    concurrent_queue_with_min(const concurrent_queue_with_min&) = delete;
+    concurrent_queue_with_min& operator=(const concurrent_queue_with_min&) = delete;
+
+    /// \b Complexity: O(1)
+    void push_back(value_type&& v) {
+        emplace_back(std::move(v));
+    }
+
+    /// \b Complexity: O(1)
+    void push_back(const value_type& v) {
+        emplace_back(v);
+    }
+
+    /// \b Complexity: O(1). Wakes up one consumer, and all the wait_min_below() waiters if min() changed.
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_COROUTINES
+        // Awaiters are registered only for empty queue, so the value goes directly to the oldest one.
+        if (!awaiters_.empty()) {
+            pop_awaiter* const a = awaiters_.front();
+            a->result_.emplace(std::forward<Args>(args)...);
+            awaiters_.pop_front();
+            lock.unlock();
+            a->handle_.resume();
+            return;
+        }
+#endif
+
+        queue_.min_listener().changed = false;
+        queue_.emplace_back(std::forward<Args>(args)...);
+        const bool min_changed = queue_.min_listener().changed;
+        lock.unlock();
+
+        not_empty_.notify_one();
+        if (min_changed) {
+            min_changed_.notify_all();
+        }
+    }
+
+    /// \b Complexity: amort O(1). Returns false if the queue is empty.
+    bool try_pop(value_type& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+
+        out = pop_front_locked();
+        return true;
+    }
+
+    /// \b Complexity: amort O(1). Blocks until the queue is not empty.
+    value_type wait_pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return !queue_.empty(); });
+        return pop_front_locked();
+    }
+
+    /// \b Complexity: O(1). Blocks until min() becomes less than `threshold` and returns that min().
+    value_type wait_min_below(const value_type& threshold) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        min_changed_.wait(lock, [this, &threshold]() {
+            return !queue_.empty() && queue_.min() < threshold;
+        });
+        return queue_.min();
+    }
+
+    /// \b Complexity: O(1). Returns false if the queue is empty.
+    bool try_min(value_type& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+
+        out = queue_.min();
+        return true;
+    }
+
+    /// \b Complexity: same as for queue_with_min::size()
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+    /// \b Complexity: O(1)
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.empty();
+    }
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_COROUTINES
+    /**
+    Awaitable returned by async_pop(). Suspended coroutine is resumed by the thread that pushes the value.
+    If the suspended coroutine is destroyed instead, the awaiter unregisters itself from the queue.
+    */
+    class pop_awaiter {
+        concurrent_queue_with_min&  q_;
+        std::optional<value_type>   result_;
+        std::coroutine_handle<>     handle_;
+
+        friend class concurrent_queue_with_min;
+
+    public:
+        explicit pop_awaiter(concurrent_queue_with_min& q) noexcept
+            : q_(q)
+        {}
+
+        pop_awaiter(const pop_awaiter&) = delete;
+        pop_awaiter& operator=(const pop_awaiter&) = delete;
+
+        ~pop_awaiter() {
+            if (!handle_) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(q_.mutex_);
+            const auto it = std::find(q_.awaiters_.begin(), q_.awaiters_.end(), this);
+            if (it != q_.awaiters_.end()) {
+                q_.awaiters_.erase(it);
+            }
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(q_.mutex_);
+            if (!q_.queue_.empty()) {
+                result_.emplace(q_.pop_front_locked());
+                return false;
+            }
+
+            handle_ = h;
+            q_.awaiters_.push_back(this);
+            return true;
+        }
+
+        value_type await_resume() {
+            return std::move(*result_);
+        }
+    };
+
+    /// \b Complexity: amort O(1). `co_await q.async_pop()` suspends the coroutine until the queue is not empty.
+    pop_awaiter async_pop() noexcept {
+        return pop_awaiter(*this);
+    }
+#endif
+};
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_CONCURRENT_QUEUE_WITH_MIN_HPP
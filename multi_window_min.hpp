@@ -0,0 +1,183 @@
+#ifndef EXAMPLES_MULTI_WINDOW_MIN_HPP
+#define EXAMPLES_MULTI_WINDOW_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+#include <cassert>
+
+
+namespace examples_v2 {
+
+/**
+Minimums of the last K1, K2, ... KN pushed elements. Elements are stored once in a ring of
+max(Ki) elements, each horizon keeps only the queue_with_min style min state over that ring:
+its own cut point between the ready and raw elements, suffix minima of the ready elements
+and the min of the raw ones.
+
+T must be DefaultConstructible and CopyAssignable.
+*/
+template <class T>
+class multi_window_min {
+    struct window_t {
+        std::size_t                 horizon;
+        std::uint64_t               head;       // [head, ready_end) are ready, [ready_end, tail_) are raw
+        std::uint64_t               ready_end;
+        std::uint64_t               min_raw;    // valid if ready_end != tail_
+        std::vector<std::uint32_t>  min_ready;  // offsets in ring_
+    };
+
+    std::vector<T>          ring_;
+    std::uint64_t           tail_;
+    std::vector<window_t>   windows_;
+
+    const T& at(std::uint64_t pos) const noexcept {
+        return ring_[pos % ring_.size()];
+    }
+
+    void make_ready(window_t& w) {
+        assert(w.min_ready.empty());
+        w.ready_end = tail_;
+
+        for (std::uint64_t pos = tail_; pos != w.head; --pos) {
+            if (w.min_ready.empty() || at(pos - 1) < ring_[w.min_ready.back()]) {
+                w.min_ready.push_back(static_cast<std::uint32_t>((pos - 1) % ring_.size()));
+            }
+        }
+    }
+
+    void pop_front(window_t& w) {
+        if (w.head == w.ready_end) {
+            make_ready(w);
+        }
+
+        if (w.min_ready.back() == w.head % ring_.size()) {
+            w.min_ready.pop_back();
+        }
+        ++ w.head;
+    }
+
+    template <class It>
+    void init(It begin, It end) {
+        std::size_t max_horizon = 0;
+        for (; begin != end; ++begin) {
+            if (!*begin || *begin > (std::numeric_limits<std::uint32_t>::max)()) {
+                throw std::invalid_argument("examples_v2::multi_window_min: horizon must be in [1, 2^32 - 1]");
+            }
+
+            const window_t w = { static_cast<std::size_t>(*begin), 0, 0, 0, std::vector<std::uint32_t>() };
+            windows_.push_back(w);
+            max_horizon = (std::max)(max_horizon, w.horizon);
+        }
+
+        if (windows_.empty()) {
+            throw std::invalid_argument("examples_v2::multi_window_min: at least one horizon is required");
+        }
+
+        ring_.resize(max_horizon);
+    }
+
+public:
+    typedef T value_type;
+
+    /// \b Complexity: O(max(Ki) + N)
+    template <class It>
+    multi_window_min(It horizons_begin, It horizons_end)
+        : tail_(0)
+    {
+        init(horizons_begin, horizons_end);
+    }
+
+    /// \b Complexity: O(max(Ki) + N)
+    multi_window_min(std::initializer_list<std::size_t> horizons)
+        : tail_(0)
+    {
+        init(horizons.begin(), horizons.end());
+    }
+
+    /// Evicts the elements that left the horizons and pushes `v`. \b Complexity: amort O(N)
+    void push_back(const value_type& v) {
+        for (std::size_t i = 0; i < windows_.size(); ++i) {
+            if (tail_ - windows_[i].head == windows_[i].horizon) {
+                pop_front(windows_[i]);
+            }
+        }
+
+        const std::uint64_t pos = tail_;
+        ring_[pos % ring_.size()] = v;
+        ++ tail_;
+
+        for (std::size_t i = 0; i < windows_.size(); ++i) {
+            window_t& w = windows_[i];
+            if (w.ready_end == pos || v < at(w.min_raw)) {
+                w.min_raw = pos;
+            }
+        }
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& min(std::size_t horizon_index) const {
+        const window_t& w = windows_[horizon_index];
+        if (w.head == w.ready_end) {
+            return at(w.min_raw);
+        }
+
+        const value_type& min_ready = ring_[w.min_ready.back()];
+        if (w.ready_end == tail_) {
+            return min_ready;
+        }
+
+        const value_type& min_raw = at(w.min_raw);
+        return min_raw < min_ready ? min_raw : min_ready;
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& front(std::size_t horizon_index) const {
+        return at(windows_[horizon_index].head);
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& back() const {
+        return at(tail_ - 1);
+    }
+
+    /// Count of the elements in the horizon. \b Complexity: O(1)
+    std::size_t size(std::size_t horizon_index) const noexcept {
+        return static_cast<std::size_t>(tail_ - windows_[horizon_index].head);
+    }
+
+    /// \b Complexity: O(1)
+    bool empty() const noexcept {
+        return !size(0);
+    }
+
+    /// \b Complexity: O(1)
+    std::size_t horizons_count() const noexcept {
+        return windows_.size();
+    }
+
+    /// \b Complexity: O(1)
+    std::size_t horizon(std::size_t horizon_index) const noexcept {
+        return windows_[horizon_index].horizon;
+    }
+
+    /// \b Complexity: O(N)
+    void clear() noexcept {
+        for (std::size_t i = 0; i < windows_.size(); ++i) {
+            windows_[i].head = windows_[i].ready_end = tail_;
+            windows_[i].min_ready.clear();
+        }
+    }
+};
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_MULTI_WINDOW_MIN_HPP
@@ -6,7 +6,7 @@ CONFIG -= qt
 QMAKE_CXX = gcc
 QMAKE_CXXFLAGS += -std=c++0x -D_GLIBCXX_DEBUG
 INCLUDEPATH += /home/antoshkka/boost_maintain/boost
-SOURCES += test.cpp test_v2.cpp queue_with_min_v2.hpp queue_with_min_v1.hpp
+SOURCES += test.cpp test_v2.cpp test_concurrent.cpp test_seqlock.cpp test_shm.cpp test_multi_window.cpp test_sliding_min.cpp test_trace.cpp test_bucketed.cpp queue_with_min_v2.hpp queue_with_min_v1.hpp concurrent_queue_with_min.hpp seqlock_queue_with_min.hpp shm_queue_with_min.hpp multi_window_min.hpp sliding_min.hpp trace_queue_with_min.hpp bucketed_queue_with_min.hpp
 
-LIBS += -lgtest -pthread
+LIBS += -lgtest -pthread -lrt
 
@@ -35,10 +35,13 @@ public:
         , min_(data_.cend())
     {}
 
-    /**
-    \b Complexity: O(1)
-    */
-    queue_with_min(queue_with_min&& q) = default;
+    /// Leaves `q` empty. \b Complexity: O(1)
+    queue_with_min(queue_with_min&& q) noexcept
+        : data_()
+        , min_(data_.cend())
+    {
+        swap(q);
+    }
 
     queue_with_min(const queue_with_min& q)
         : data_(q.data_)
@@ -50,7 +53,15 @@ public:
        , min_( std::min_element(data_.cbegin(), data_.cend()) )
    {}
 
-    queue_with_min& operator=(queue_with_min&& q) = default;
+    /// Leaves `q` empty. \b Complexity: O(N) to destroy own elements
+    queue_with_min& operator=(queue_with_min&& q) noexcept {
+        if (this != &q) {
+            clear();
+            swap(q);
+        }
+
+        return *this;
+    }
 
     queue_with_min& operator=(const queue_with_min& q) {
         if (this == &q) {
@@ -169,6 +180,15 @@ public:
         data_.clear();
         min_ = data_.cend();
     }
+
+    /// \b Complexity: O(1)
+    void swap(queue_with_min& q) noexcept {
+        // Iterators to elements follow the elements, but end() iterators are not swapped
+        data_.swap(q.data_);
+        const data_ptr_t new_min = (data_.empty() ? data_.cend() : q.min_);
+        q.min_ = (q.data_.empty() ? q.data_.cend() : min_);
+        min_ = new_min;
+    }
 };
 
 template <class T>
@@ -176,6 +196,11 @@ inline bool operator==(const queue_with_min<T>& lhs, const queue_with_min<T>& rh
     return lhs.equal(rhs);
 }
 
+template <class T>
+inline void swap(queue_with_min<T>& lhs, queue_with_min<T>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
 } // namespace examples_v1
 
 #endif // EXAMPLES_QUEUE_WITH_MIN_V1_HPP
@@ -6,30 +6,91 @@
 #pragma once
 #endif
 
+#include <boost/range/iterator_range.hpp>
+
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
 #include <cassert>
+#include <utility>
 
 
 namespace examples_v2 {
 
+/// Default MinListener of queue_with_min. Does nothing, min changes are not tracked at all.
+struct null_min_listener {
+    template <class T>
+    void operator()(const T& /*new_min*/) const noexcept {}
+};
+
+namespace detail {
+
+/// Arithmetic types are trivially copyable and are compared in registers. bool is excluded, because std::vector<bool> has no data().
 template <class T>
+struct use_flat_storage: std::integral_constant<bool,
+    std::is_arithmetic<T>::value && !std::is_same<typename std::remove_cv<T>::type, bool>::value
+> {};
+
+} // namespace detail
+
+/// How queue_with_min maintains the min of the elements pushed by emplace_back().
+enum class min_tracking {
+    eager,  ///< emplace_back() updates the min. Good for frequent min() calls.
+    lazy    ///< emplace_back() does not touch the min, first min() after the pushes scans the new elements.
+};
+
+/**
+\tparam MinListener Functional object that is called with the new value of min() each time
+emplace_back(), pop_front(), append(), split_at() or drain(value_type*, std::size_t) actually change the min() of a non empty queue.
+
+\tparam Flat Selects the contiguous storage specialization. By default it is used for arithmetic types,
+all the other types (including move only ones) are stored in std::list. Flat may be set to true only for
+trivially copyable types other than bool with std::numeric_limits specialization. Unlike the std::list storage, it does not keep
+references to the elements valid: see queue_with_min<T, MinListener, true> for the invalidation rules.
+*/
+template <class T, class MinListener = null_min_listener, bool Flat = detail::use_flat_storage<T>::value>
 class queue_with_min {
     typedef std::list<T> data_t;
     typedef typename data_t::const_iterator data_ptr_t;
+    typedef std::is_same<MinListener, null_min_listener> listener_disabled_t;
 
     data_t                  data_raw_;
-    data_ptr_t              min_raw_;
+    mutable data_ptr_t      min_raw_;
+    mutable data_ptr_t      raw_scanned_;   // last element of data_raw_ accounted in min_raw_
 
     data_t                  data_ready_;
     std::vector<data_ptr_t> min_ready_;
 
+    MinListener             listener_;
+    min_tracking            tracking_;
+
 
     data_ptr_t pointer_to_last_raw() const noexcept {
         return std::prev(data_raw_.end());
     }
 
+    void reset_raw_scan() const noexcept {
+        raw_scanned_ = (data_raw_.empty() ? data_raw_.cend() : pointer_to_last_raw());
+    }
+
+    void sync_min_raw() const {
+        const auto end = data_raw_.cend();
+        auto it = (raw_scanned_ == end ? data_raw_.cbegin() : std::next(raw_scanned_));
+        for (; it != end; ++it) {
+            if (min_raw_ == end || *it < *min_raw_) {
+                min_raw_ = it;
+            }
+        }
+
+        reset_raw_scan();
+    }
+
     void setup_min_ready() {
         assert(min_ready_.empty());
 
@@ -47,46 +108,114 @@ class queue_with_min {
 
         data_raw_.swap(data_ready_);
         min_raw_ = data_raw_.cbegin();
+        reset_raw_scan();
 
         setup_min_ready();
     }
 
+    void swap_data(queue_with_min& q) noexcept {
+        // Iterators to elements follow the elements, but end() iterators are not swapped
+        const bool min_at_end = (min_raw_ == data_raw_.cend());
+        const bool scanned_at_end = (raw_scanned_ == data_raw_.cend());
+        const bool q_min_at_end = (q.min_raw_ == q.data_raw_.cend());
+        const bool q_scanned_at_end = (q.raw_scanned_ == q.data_raw_.cend());
+
+        data_raw_.swap(q.data_raw_);
+
+        const data_ptr_t min_raw = (q_min_at_end ? data_raw_.cend() : q.min_raw_);
+        q.min_raw_ = (min_at_end ? q.data_raw_.cend() : min_raw_);
+        min_raw_ = min_raw;
+
+        const data_ptr_t raw_scanned = (q_scanned_at_end ? data_raw_.cend() : q.raw_scanned_);
+        q.raw_scanned_ = (scanned_at_end ? q.data_raw_.cend() : raw_scanned_);
+        raw_scanned_ = raw_scanned;
+
+        data_ready_.swap(q.data_ready_);
+        min_ready_.swap(q.min_ready_);
+    }
+
 public:
     typedef T value_type;
 
+    /// Read only range of the elements, see segments().
+    typedef boost::iterator_range<data_ptr_t> segment_type;
+
     /// \b Complexity: O(1)
     queue_with_min() noexcept
         : data_raw_()
         , min_raw_(data_raw_.cend())
+        , raw_scanned_(data_raw_.cend())
+        , tracking_(min_tracking::eager)
     {}
 
-    /**
-    \b Complexity: O(1)
-    */
-    queue_with_min(queue_with_min&& q) = default;
+    /// \b Complexity: O(1)
+    explicit queue_with_min(const MinListener& listener)
+        : data_raw_()
+        , min_raw_(data_raw_.cend())
+        , raw_scanned_(data_raw_.cend())
+        , listener_(listener)
+        , tracking_(min_tracking::eager)
+    {}
+
+    /// Leaves `q` empty. \b Complexity: O(1)
+    queue_with_min(queue_with_min&& q) noexcept(std::is_nothrow_move_constructible<MinListener>::value)
+        : data_raw_()
+        , min_raw_(data_raw_.cend())
+        , raw_scanned_(data_raw_.cend())
+        , data_ready_()
+        , min_ready_()
+        , listener_(std::move(q.listener_))
+        , tracking_(q.tracking_)
+    {
+        swap_data(q);
+    }
 
 
     queue_with_min(const queue_with_min& q)
         : data_raw_(q.data_raw_)
         , min_raw_( std::min_element(data_raw_.cbegin(), data_raw_.cend()) )
+        , raw_scanned_()
         , data_ready_(q.data_ready_)
         , min_ready_()
+        , listener_(q.listener_)
+        , tracking_(q.tracking_)
     {
+        reset_raw_scan();
         setup_min_ready();
     }
 
     queue_with_min(std::initializer_list<value_type> il)
         : data_raw_(il)
         , min_raw_( std::min_element(data_raw_.cbegin(), data_raw_.cend()) )
-    {}
+        , raw_scanned_()
+        , tracking_(min_tracking::eager)
+    {
+        reset_raw_scan();
+    }
 
     template <class It>
     queue_with_min(It begin, It end)
         : data_raw_(begin, end)
         , min_raw_( std::min_element(data_raw_.cbegin(), data_raw_.cend()) )
-    {}
+        , raw_scanned_()
+        , tracking_(min_tracking::eager)
+    {
+        reset_raw_scan();
+    }
 
-    queue_with_min& operator=(queue_with_min&& q) = default;
+    /// Leaves `q` empty. \b Complexity: O(N) to destroy own elements
+    queue_with_min& operator=(queue_with_min&& q) noexcept(std::is_nothrow_move_assignable<MinListener>::value) {
+        if (this == &q) {
+            return *this;
+        }
+
+        clear();
+        swap_data(q);
+        listener_ = std::move(q.listener_);
+        tracking_ = q.tracking_;
+
+        return *this;
+    }
 
     queue_with_min& operator=(const queue_with_min& q) {
         if (this == &q) {
@@ -95,9 +224,12 @@ public:
 
         data_raw_ = q.data_raw_;
         min_raw_ = std::min_element(data_raw_.cbegin(), data_raw_.cend());
+        reset_raw_scan();
         data_ready_ = q.data_ready_;
         min_ready_.clear();
         setup_min_ready();
+        listener_ = q.listener_;
+        tracking_ = q.tracking_;
 
         return *this;
     }
@@ -107,6 +239,7 @@ public:
 
         data_raw_ = il;
         min_raw_ = std::min_element(data_raw_.cbegin(), data_raw_.cend());
+        reset_raw_scan();
         return *this;
     }
 
@@ -125,11 +258,20 @@ public:
     /// \b Complexity: O(1)
     template <class... Args>
     void emplace_back(Args&&... args) {
+        if (tracking_ == min_tracking::lazy) {
+            data_raw_.emplace_back(std::forward<Args>(args)...);
+            return;
+        }
+
         const bool need_reinit = (min_raw_ == data_raw_.cend());
         data_raw_.emplace_back(std::forward<Args>(args)...);
 
         if (need_reinit || data_raw_.back() < *min_raw_) {
             min_raw_ = pointer_to_last_raw();
+
+            if (!listener_disabled_t::value && (data_ready_.empty() || *min_raw_ < *min_ready_.back())) {
+                listener_(*min_raw_);
+            }
         }
     }
 
@@ -147,11 +289,26 @@ public:
             make_ready();
         }
 
-        if (data_ready_.cbegin() == min_ready_.back()) {
+        const bool min_popped = (data_ready_.cbegin() == min_ready_.back());
+        if (min_popped) {
             min_ready_.pop_back();
         }
 
+        if (listener_disabled_t::value || !min_popped) {
+            data_ready_.pop_front();
+            return;
+        }
+
+        const value_type* new_min = (min_ready_.empty() ? nullptr : &*min_ready_.back());
+        if (!data_raw_.empty() && (!new_min || *min_raw_ < *new_min)) {
+            new_min = &*min_raw_;
+        }
+
+        const bool min_changed = (new_min && data_ready_.front() < *new_min);
         data_ready_.pop_front();
+        if (min_changed) {
+            listener_(*new_min);
+        }
     }
 
     /// \b Complexity: O(1)
@@ -160,19 +317,184 @@ public:
     }
 
 
+    // splice
+
+    /**
+    Moves all the elements of `q` to the end of this queue, `q` becomes empty.
+
+    \b Complexity: O(1) [std::list::splice], plus the min() complexity for min_tracking::lazy.
+    */
+    void append(queue_with_min&& q) {
+        assert(this != &q);
+        if (q.empty()) {
+            return;
+        }
+
+        if (tracking_ == min_tracking::lazy) {
+            sync_min_raw();
+        }
+        if (q.tracking_ == min_tracking::lazy) {
+            q.sync_min_raw();
+        }
+
+        data_ptr_t q_min = q.min_raw_;
+        if (!q.data_ready_.empty() && (q.data_raw_.empty() || !(*q.min_raw_ < *q.min_ready_.back()))) {
+            q_min = q.min_ready_.back();
+        }
+
+        const bool min_changed = (empty() || *q_min < min());
+        const bool need_reinit = (min_raw_ == data_raw_.cend());
+
+        // Iterators of spliced elements remain valid and now refer to data_raw_
+        data_raw_.splice(data_raw_.cend(), q.data_ready_);
+        data_raw_.splice(data_raw_.cend(), q.data_raw_);
+        q.clear();
+
+        if (need_reinit || *q_min < *min_raw_) {
+            min_raw_ = q_min;
+        }
+        reset_raw_scan();
+
+        if (!listener_disabled_t::value && min_changed) {
+            listener_(*min_raw_);
+        }
+    }
+
+    /**
+    Removes the elements starting from position `n` and returns them as a new queue with the same
+    MinListener and min_tracking.
+
+    \b Complexity: O(N)
+    */
+    queue_with_min split_at(std::size_t n) {
+        assert(n <= size());
+
+        queue_with_min tail(listener_);
+        tail.tracking_ = tracking_;
+
+        const value_type* const old_min = (listener_disabled_t::value || empty() ? nullptr : &min());
+        const std::size_t ready_size = data_ready_.size();
+        if (n < ready_size) {
+            tail.data_raw_.splice(tail.data_raw_.cend(), data_ready_, std::next(data_ready_.cbegin(), n), data_ready_.cend());
+            tail.data_raw_.splice(tail.data_raw_.cend(), data_raw_);
+
+            min_ready_.clear();
+            setup_min_ready();
+        } else {
+            tail.data_raw_.splice(tail.data_raw_.cend(), data_raw_, std::next(data_raw_.cbegin(), n - ready_size), data_raw_.cend());
+        }
+
+        min_raw_ = std::min_element(data_raw_.cbegin(), data_raw_.cend());
+        reset_raw_scan();
+        tail.min_raw_ = std::min_element(tail.data_raw_.cbegin(), tail.data_raw_.cend());
+        tail.reset_raw_scan();
+
+        // old_min is alive: it was moved to the tail or remains here
+        if (old_min && !empty() && *old_min < min()) {
+            listener_(min());
+        }
+
+        return tail;
+    }
+
+
+    // segments
+
+    /// Elements in the order of pop_front(): ready elements followed by the raw ones. Some segments may be empty.
+    std::array<segment_type, 2> segments() const noexcept {
+        const std::array<segment_type, 2> res = {{
+            segment_type(data_ready_.cbegin(), data_ready_.cend()),
+            segment_type(data_raw_.cbegin(), data_raw_.cend())
+        }};
+        return res;
+    }
+
+    /**
+    Calls `f(segment)` for each non empty segment in order and removes all the elements.
+    If `f` throws, the queue is not modified.
+
+    \b Complexity: O(N)
+    */
+    template <class F>
+    void drain(F f) {
+        if (!data_ready_.empty()) {
+            f(segment_type(data_ready_.cbegin(), data_ready_.cend()));
+        }
+        if (!data_raw_.empty()) {
+            f(segment_type(data_raw_.cbegin(), data_raw_.cend()));
+        }
+
+        clear();
+    }
+
+    /**
+    Moves up to `count` elements from the front into `out` and removes them.
+    Returns the count of moved elements.
+
+    \b Complexity: O(count)
+    */
+    std::size_t drain(value_type* out, std::size_t count) {
+        count = (std::min)(count, size());
+        const value_type* const old_min = (listener_disabled_t::value || !count ? nullptr : &min());
+        const value_type* old_min_out = nullptr;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (data_ready_.empty()) {
+                make_ready();
+            }
+
+            if (data_ready_.cbegin() == min_ready_.back()) {
+                min_ready_.pop_back();
+            }
+
+            if (&data_ready_.front() == old_min) {
+                old_min_out = out + i;
+            }
+
+            out[i] = std::move(data_ready_.front());
+            data_ready_.pop_front();
+        }
+
+        if (old_min_out && !empty() && *old_min_out < min()) {
+            listener_(min());
+        }
+
+        return count;
+    }
+
+
     // misc
     /// \b Complexity: same as for std::list.size() [O(1) or O(N) for old libstdc++]
     std::size_t size() const noexcept {
         return data_raw_.size() + data_ready_.size();
     }
 
+    /**
+    Bytes occupied by the queue, including the reserved but unused memory of the min index.
+    List nodes are estimated as a value and two pointers, allocator overhead is not accounted.
+
+    \b Complexity: same as for size()
+    */
+    std::size_t memory_usage() const noexcept {
+        BOOST_CONSTEXPR_OR_CONST std::size_t node_size = (sizeof(T) + 2 * sizeof(void*) + alignof(void*) - 1)
+            / alignof(void*) * alignof(void*);
+
+        return sizeof(*this)
+            + size() * node_size
+            + min_ready_.capacity() * sizeof(data_ptr_t);
+    }
+
     /// \b Complexity: O(1)
     bool empty() const noexcept {
         return data_ready_.empty() && data_raw_.empty();
     }
 
-    /// \b Complexity: O(1)
+    /// \b Complexity: O(1) for min_tracking::eager; O(K) for min_tracking::lazy, where K is the count of elements pushed since the previous min() call.
     const value_type& min() const {
+        if (tracking_ == min_tracking::lazy) {
+            sync_min_raw();
+        }
+
         if (!data_ready_.empty() && !data_raw_.empty()) {
             return *min_raw_ < *min_ready_.back() ? *min_raw_ : *min_ready_.back();
         } else if (!data_ready_.empty()) {
@@ -182,8 +504,42 @@ public:
         return *min_raw_;
     }
 
-   /// \b Complexity: O(N)
-    bool equal(const queue_with_min<T>& q) const noexcept {
+    /**
+    Changes the way the min of the pushed elements is maintained. Queues with MinListener always use
+    min_tracking::eager, because notifications require the comparisons in emplace_back().
+
+    Note that for min_tracking::lazy the min() call modifies the internal state, so concurrent min() calls
+    must be synchronized.
+
+    \b Complexity: O(1), or same as for min() when switching from min_tracking::lazy
+    */
+    void set_min_tracking(min_tracking t) {
+        if (tracking_ == min_tracking::lazy) {
+            sync_min_raw();
+        } else {
+            reset_raw_scan();
+        }
+
+        tracking_ = (listener_disabled_t::value ? t : min_tracking::eager);
+    }
+
+    /// \b Complexity: O(1)
+    min_tracking get_min_tracking() const noexcept {
+        return tracking_;
+    }
+
+    /// \b Complexity: O(1)
+    MinListener& min_listener() noexcept {
+        return listener_;
+    }
+
+    /// \b Complexity: O(1)
+    const MinListener& min_listener() const noexcept {
+        return listener_;
+    }
+
+    /// \b Complexity: O(N)
+    bool equal(const queue_with_min& q) const noexcept {
         if (size() != q.size()) {
             return false;
         }
@@ -225,17 +581,609 @@ public:
     void clear() noexcept {
         data_raw_.clear();
         min_raw_ = data_raw_.cend();
+        raw_scanned_ = data_raw_.cend();
 
         data_ready_.clear();
         min_ready_.clear();
     }
+
+    /// \b Complexity: O(1)
+    void swap(queue_with_min& q) noexcept(noexcept(std::swap(std::declval<MinListener&>(), std::declval<MinListener&>()))) {
+        using std::swap;
+
+        swap_data(q);
+        swap(listener_, q.listener_);
+        swap(tracking_, q.tracking_);
+    }
 };
 
-template <class T>
-inline bool operator==(const queue_with_min<T>& lhs, const queue_with_min<T>& rhs) noexcept {
+/**
+Specialization for arithmetic types. Elements are stored in contiguous memory, so the bulk copies
+are memcpy, min updates in emplace_back() are branchless and clear() is O(1).
+
+References and segments are invalidated differently than for the std::list storage:
+\li references returned by front(), back() and segments() may be invalidated by any push, append() and split_at(),
+    pop_front() invalidates only the references to the popped element;
+\li reference returned by min() may refer to an internal cache, so its value may change after any modification
+    of the queue. Copy the min() if it is needed after the modification.
+
+T must be trivially copyable, must not be bool and must have std::numeric_limits specialization.
+min() always returns one of the elements, but for floating point elements with NaNs it is not
+necessarily the least one, just like for the std::list storage.
+*/
+template <class T, class MinListener>
+class queue_with_min<T, MinListener, true> {
+    static_assert(
+        std::numeric_limits<T>::is_specialized && std::is_trivially_copyable<T>::value
+            && !std::is_same<typename std::remove_cv<T>::type, bool>::value,
+        "examples_v2::queue_with_min: contiguous storage requires trivially copyable non bool T with std::numeric_limits specialization"
+    );
+
+    typedef std::vector<T> data_t;
+    typedef std::is_same<MinListener, null_min_listener> listener_disabled_t;
+
+    data_t                      data_raw_;
+    mutable T                   min_raw_;       // one of the accounted data_raw_ elements, min_identity() if there are none
+    mutable std::size_t         raw_scanned_;   // data_raw_[0, raw_scanned_) are accounted in min_raw_
+
+    data_t                      data_ready_;
+    std::size_t                 ready_begin_;   // data_ready_[0, ready_begin_) are already popped
+    std::vector<std::uint32_t>  min_ready_;     // offsets in data_ready_, 4 bytes per suffix minimum
+
+    MinListener                 listener_;
+    min_tracking                tracking_;
+
+
+    static BOOST_CONSTEXPR T min_identity() noexcept {
+        return std::numeric_limits<T>::has_infinity
+            ? std::numeric_limits<T>::infinity()
+            : (std::numeric_limits<T>::max)();
+    }
+
+    // Returns one of the elements, min_identity() only for an empty range
+    static T min_of(const T* begin, const T* end) noexcept {
+        if (begin == end) {
+            return min_identity();
+        }
+
+        // Independent accumulators break the dependency chain, so the compiler is free to use SIMD min
+        T m0 = *begin, m1 = m0, m2 = m0, m3 = m0;
+        for (; end - begin >= 4; begin += 4) {
+            m0 = (begin[0] < m0 ? begin[0] : m0);
+            m1 = (begin[1] < m1 ? begin[1] : m1);
+            m2 = (begin[2] < m2 ? begin[2] : m2);
+            m3 = (begin[3] < m3 ? begin[3] : m3);
+        }
+        for (; begin != end; ++begin) {
+            m0 = (*begin < m0 ? *begin : m0);
+        }
+
+        m0 = (m1 < m0 ? m1 : m0);
+        m2 = (m3 < m2 ? m3 : m2);
+        return m2 < m0 ? m2 : m0;
+    }
+
+    void sync_min_raw() const noexcept {
+        if (raw_scanned_ == data_raw_.size()) {
+            return;
+        }
+
+        const T* const data = data_raw_.data();
+        const T tail_min = min_of(data + raw_scanned_, data + data_raw_.size());
+        min_raw_ = (!raw_scanned_ || tail_min < min_raw_ ? tail_min : min_raw_);
+        raw_scanned_ = data_raw_.size();
+    }
+
+    bool ready_empty() const noexcept {
+        return ready_begin_ == data_ready_.size();
+    }
+
+    const T& at(std::size_t i) const noexcept {
+        const std::size_t ready_size = data_ready_.size() - ready_begin_;
+        return i < ready_size ? data_ready_[ready_begin_ + i] : data_raw_[i - ready_size];
+    }
+
+    void setup_min_ready() {
+        assert(min_ready_.empty());
+
+        T current_min = min_identity();
+        for (std::size_t i = data_ready_.size(); i != ready_begin_; --i) {
+            if (min_ready_.empty() || data_ready_[i - 1] < current_min) {
+                current_min = data_ready_[i - 1];
+                min_ready_.push_back(static_cast<std::uint32_t>(i - 1));
+            }
+        }
+    }
+
+    void make_ready() {
+        assert(ready_empty());
+
+        data_raw_.swap(data_ready_);
+        data_raw_.clear();
+        min_raw_ = min_identity();
+        raw_scanned_ = 0;
+        ready_begin_ = 0;
+
+        setup_min_ready();
+    }
+
+    void copy_ready(const queue_with_min& q) {
+        data_ready_.assign(q.data_ready_.data() + q.ready_begin_, q.data_ready_.data() + q.data_ready_.size());
+        ready_begin_ = 0;
+
+        min_ready_.resize(q.min_ready_.size());
+        for (std::size_t i = 0; i < min_ready_.size(); ++i) {
+            min_ready_[i] = static_cast<std::uint32_t>(q.min_ready_[i] - q.ready_begin_);
+        }
+    }
+
+    void check_size() const {
+        if (data_raw_.size() > max_size()) {
+            throw std::length_error("examples_v2::queue_with_min: too many elements for 32 bit offsets");
+        }
+    }
+
+public:
+    typedef T value_type;
+
+    /// Contiguous read only range of the elements, see segments().
+    typedef boost::iterator_range<const T*> segment_type;
+
+    /// \b Complexity: O(1)
+    queue_with_min() noexcept
+        : data_raw_()
+        , min_raw_(min_identity())
+        , raw_scanned_(0)
+        , ready_begin_(0)
+        , tracking_(min_tracking::eager)
+    {}
+
+    /// \b Complexity: O(1)
+    explicit queue_with_min(const MinListener& listener)
+        : data_raw_()
+        , min_raw_(min_identity())
+        , raw_scanned_(0)
+        , ready_begin_(0)
+        , listener_(listener)
+        , tracking_(min_tracking::eager)
+    {}
+
+    /// Leaves `q` empty. \b Complexity: O(1)
+    queue_with_min(queue_with_min&& q) noexcept(std::is_nothrow_move_constructible<MinListener>::value)
+        : data_raw_(std::move(q.data_raw_))
+        , min_raw_(q.min_raw_)
+        , raw_scanned_(q.raw_scanned_)
+        , data_ready_(std::move(q.data_ready_))
+        , ready_begin_(q.ready_begin_)
+        , min_ready_(std::move(q.min_ready_))
+        , listener_(std::move(q.listener_))
+        , tracking_(q.tracking_)
+    {
+        q.clear();
+    }
+
+    /// \b Complexity: O(N), memcpy of the elements.
+    queue_with_min(const queue_with_min& q)
+        : data_raw_(q.data_raw_)
+        , min_raw_(q.min_raw_)
+        , raw_scanned_(q.raw_scanned_)
+        , data_ready_()
+        , ready_begin_(0)
+        , min_ready_()
+        , listener_(q.listener_)
+        , tracking_(q.tracking_)
+    {
+        copy_ready(q);
+    }
+
+    queue_with_min(std::initializer_list<value_type> il)
+        : data_raw_(il)
+        , min_raw_( min_of(data_raw_.data(), data_raw_.data() + data_raw_.size()) )
+        , raw_scanned_(data_raw_.size())
+        , ready_begin_(0)
+        , tracking_(min_tracking::eager)
+    {
+        check_size();
+    }
+
+    template <class It>
+    queue_with_min(It begin, It end)
+        : data_raw_(begin, end)
+        , min_raw_( min_of(data_raw_.data(), data_raw_.data() + data_raw_.size()) )
+        , raw_scanned_(data_raw_.size())
+        , ready_begin_(0)
+        , tracking_(min_tracking::eager)
+    {
+        check_size();
+    }
+
+    /// Leaves `q` empty. \b Complexity: O(1)
+    queue_with_min& operator=(queue_with_min&& q) noexcept(std::is_nothrow_move_assignable<MinListener>::value) {
+        if (this == &q) {
+            return *this;
+        }
+
+        data_raw_ = std::move(q.data_raw_);
+        min_raw_ = q.min_raw_;
+        raw_scanned_ = q.raw_scanned_;
+        data_ready_ = std::move(q.data_ready_);
+        ready_begin_ = q.ready_begin_;
+        min_ready_ = std::move(q.min_ready_);
+        listener_ = std::move(q.listener_);
+        tracking_ = q.tracking_;
+        q.clear();
+
+        return *this;
+    }
+
+    queue_with_min& operator=(const queue_with_min& q) {
+        if (this == &q) {
+            return *this;
+        }
+
+        data_raw_ = q.data_raw_;
+        min_raw_ = q.min_raw_;
+        raw_scanned_ = q.raw_scanned_;
+        copy_ready(q);
+        listener_ = q.listener_;
+        tracking_ = q.tracking_;
+
+        return *this;
+    }
+
+    queue_with_min& operator=(std::initializer_list<value_type> il) {
+        clear();
+
+        data_raw_ = il;
+        check_size();
+        min_raw_ = min_of(data_raw_.data(), data_raw_.data() + data_raw_.size());
+        raw_scanned_ = data_raw_.size();
+        return *this;
+    }
+
+    // back
+
+    /// \b Complexity: O(1)
+    void push_back(value_type v) {
+        emplace_back(v);
+    }
+
+    /// \b Complexity: O(1). Throws std::length_error if size() would exceed max_size().
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        if (BOOST_UNLIKELY(data_raw_.size() == max_size())) {
+            throw std::length_error("examples_v2::queue_with_min: too many elements for 32 bit offsets");
+        }
+
+        const value_type v(std::forward<Args>(args)...);
+        if (tracking_ == min_tracking::lazy) {
+            data_raw_.push_back(v);
+            return;
+        }
+
+        const value_type prev_min = min_raw_;
+        data_raw_.push_back(v);
+        min_raw_ = (data_raw_.size() == 1 || v < min_raw_ ? v : min_raw_);
+
+        if (!listener_disabled_t::value && (data_raw_.size() == 1 || v < prev_min)
+            && (ready_empty() || v < data_ready_[min_ready_.back()]))
+        {
+            listener_(min_raw_);
+        }
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& back() const {
+        return !data_raw_.empty() ? data_raw_.back() : data_ready_.back();
+    }
+
+
+    // front
+
+    /// \b Complexity: amort O(1) [Up to O(N) additional memory and O(N) in worst case].
+    void pop_front() {
+        if (ready_empty()) {
+            make_ready();
+        }
+
+        const bool min_popped = (ready_begin_ == min_ready_.back());
+        if (min_popped) {
+            min_ready_.pop_back();
+        }
+
+        ++ ready_begin_;
+        if (listener_disabled_t::value || !min_popped || empty()) {
+            return;
+        }
+
+        const value_type& new_min = min();
+        if (data_ready_[ready_begin_ - 1] < new_min) {
+            listener_(new_min);
+        }
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& front() const {
+        return ready_empty() ? data_raw_.front() : data_ready_[ready_begin_];
+    }
+
+
+    // splice
+
+    /**
+    Moves all the elements of `q` to the end of this queue, `q` becomes empty.
+
+    \b Complexity: O(1) if this queue is empty, O(q.size()) memcpy otherwise.
+    Plus the min() complexity for min_tracking::lazy.
+    */
+    void append(queue_with_min&& q) {
+        assert(this != &q);
+        if (q.empty()) {
+            return;
+        }
+
+        if (tracking_ == min_tracking::lazy) {
+            sync_min_raw();
+        }
+        if (q.tracking_ == min_tracking::lazy) {
+            q.sync_min_raw();
+        }
+
+        const value_type q_min = q.min();
+        const bool min_changed = (empty() || q_min < min());
+
+        if (empty()) {
+            data_raw_.swap(q.data_raw_);
+            data_ready_.swap(q.data_ready_);
+            min_ready_.swap(q.min_ready_);
+            min_raw_ = q.min_raw_;
+            ready_begin_ = q.ready_begin_;
+        } else {
+            if (q.size() > max_size() - data_raw_.size()) {
+                throw std::length_error("examples_v2::queue_with_min: too many elements for 32 bit offsets");
+            }
+
+            const bool raw_was_empty = data_raw_.empty();
+            data_raw_.insert(data_raw_.end(), q.data_ready_.data() + q.ready_begin_, q.data_ready_.data() + q.data_ready_.size());
+            data_raw_.insert(data_raw_.end(), q.data_raw_.cbegin(), q.data_raw_.cend());
+            min_raw_ = (raw_was_empty || q_min < min_raw_ ? q_min : min_raw_);
+        }
+        raw_scanned_ = data_raw_.size();
+        q.clear();
+
+        if (!listener_disabled_t::value && min_changed) {
+            listener_(min());
+        }
+    }
+
+    /**
+    Removes the elements starting from position `n` and returns them as a new queue with the same
+    MinListener and min_tracking.
+
+    \b Complexity: O(N)
+    */
+    queue_with_min split_at(std::size_t n) {
+        assert(n <= size());
+        if (size() - n > max_size()) {
+            throw std::length_error("examples_v2::queue_with_min: too many elements for 32 bit offsets");
+        }
+
+        queue_with_min tail(listener_);
+        tail.tracking_ = tracking_;
+
+        const value_type old_min = (empty() ? min_identity() : min());
+        const std::size_t ready_size = data_ready_.size() - ready_begin_;
+        if (n < ready_size) {
+            const T* const first = data_ready_.data() + ready_begin_ + n;
+            const T* const last = data_ready_.data() + data_ready_.size();
+            tail.data_raw_.reserve(size() - n);
+            tail.data_raw_.assign(first, last);
+            tail.data_raw_.insert(tail.data_raw_.end(), data_raw_.cbegin(), data_raw_.cend());
+
+            data_ready_.resize(ready_begin_ + n);
+            min_ready_.clear();
+            setup_min_ready();
+            data_raw_.clear();
+        } else {
+            const std::size_t raw_size = n - ready_size;
+            tail.data_raw_.assign(data_raw_.data() + raw_size, data_raw_.data() + data_raw_.size());
+            data_raw_.resize(raw_size);
+        }
+
+        min_raw_ = min_of(data_raw_.data(), data_raw_.data() + data_raw_.size());
+        raw_scanned_ = data_raw_.size();
+        tail.min_raw_ = min_of(tail.data_raw_.data(), tail.data_raw_.data() + tail.data_raw_.size());
+        tail.raw_scanned_ = tail.data_raw_.size();
+
+        if (!listener_disabled_t::value && !empty() && old_min < min()) {
+            listener_(min());
+        }
+
+        return tail;
+    }
+
+
+    // segments
+
+    /// Same as queue_with_min<T, MinListener, false>::segments(), but the segments are contiguous.
+    std::array<segment_type, 2> segments() const noexcept {
+        const std::array<segment_type, 2> res = {{
+            segment_type(data_ready_.data() + ready_begin_, data_ready_.data() + data_ready_.size()),
+            segment_type(data_raw_.data(), data_raw_.data() + data_raw_.size())
+        }};
+        return res;
+    }
+
+    /// Same as queue_with_min<T, MinListener, false>::drain(F), but the segments are contiguous and the removal is O(1).
+    template <class F>
+    void drain(F f) {
+        if (!ready_empty()) {
+            f(segment_type(data_ready_.data() + ready_begin_, data_ready_.data() + data_ready_.size()));
+        }
+        if (!data_raw_.empty()) {
+            f(segment_type(data_raw_.data(), data_raw_.data() + data_raw_.size()));
+        }
+
+        clear();
+    }
+
+    /**
+    Copies up to `count` elements from the front into `out` and removes them.
+    Returns the count of copied elements.
+
+    \b Complexity: O(count) memcpy, amort O(1) per element for the min state.
+    */
+    std::size_t drain(value_type* out, std::size_t count) {
+        count = (std::min)(count, size());
+        const value_type old_min = (!count ? min_identity() : min());
+
+        for (std::size_t left = count; left; ) {
+            if (ready_empty()) {
+                make_ready();
+            }
+
+            const std::size_t chunk = (std::min)(left, data_ready_.size() - ready_begin_);
+            std::memcpy(out, data_ready_.data() + ready_begin_, chunk * sizeof(T));
+            out += chunk;
+            left -= chunk;
+            ready_begin_ += chunk;
+
+            while (!min_ready_.empty() && min_ready_.back() < ready_begin_) {
+                min_ready_.pop_back();
+            }
+        }
+
+        if (!listener_disabled_t::value && count && !empty() && old_min < min()) {
+            listener_(min());
+        }
+
+        return count;
+    }
+
+
+    // misc
+    /// \b Complexity: O(1)
+    std::size_t size() const noexcept {
+        return data_raw_.size() + data_ready_.size() - ready_begin_;
+    }
+
+    /// Max count of elements pushed since the previous pop_front(), limited by the 32 bit offsets of the min index.
+    static BOOST_CONSTEXPR std::size_t max_size() noexcept {
+        return (std::numeric_limits<std::uint32_t>::max)();
+    }
+
+    /// \b Complexity: O(1). Bytes occupied by the queue, including the reserved but unused memory.
+    std::size_t memory_usage() const noexcept {
+        return sizeof(*this)
+            + (data_raw_.capacity() + data_ready_.capacity()) * sizeof(T)
+            + min_ready_.capacity() * sizeof(std::uint32_t);
+    }
+
+    /// \b Complexity: O(1)
+    bool empty() const noexcept {
+        return ready_empty() && data_raw_.empty();
+    }
+
+    /**
+    Returned reference may refer to an internal cache and change its value after any modification of the queue.
+
+    \b Complexity: O(1) for min_tracking::eager; O(K) for min_tracking::lazy, where K is the count of elements pushed since the previous min() call.
+    */
+    const value_type& min() const {
+        if (tracking_ == min_tracking::lazy) {
+            sync_min_raw();
+        }
+
+        if (ready_empty()) {
+            return min_raw_;
+        }
+
+        const value_type& min_ready = data_ready_[min_ready_.back()];
+        if (data_raw_.empty()) {
+            return min_ready;
+        }
+
+        return min_raw_ < min_ready ? min_raw_ : min_ready;
+    }
+
+    /// Same as queue_with_min<T, MinListener, false>::set_min_tracking(min_tracking)
+    void set_min_tracking(min_tracking t) noexcept {
+        if (tracking_ == min_tracking::lazy) {
+            sync_min_raw();
+        } else {
+            raw_scanned_ = data_raw_.size();
+        }
+
+        tracking_ = (listener_disabled_t::value ? t : min_tracking::eager);
+    }
+
+    /// \b Complexity: O(1)
+    min_tracking get_min_tracking() const noexcept {
+        return tracking_;
+    }
+
+    /// \b Complexity: O(1)
+    MinListener& min_listener() noexcept {
+        return listener_;
+    }
+
+    /// \b Complexity: O(1)
+    const MinListener& min_listener() const noexcept {
+        return listener_;
+    }
+
+    /// \b Complexity: O(N)
+    bool equal(const queue_with_min& q) const noexcept {
+        const std::size_t count = size();
+        if (count != q.size()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (at(i) != q.at(i)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// \b Complexity: O(1)
+    void clear() noexcept {
+        data_raw_.clear();
+        min_raw_ = min_identity();
+        raw_scanned_ = 0;
+
+        data_ready_.clear();
+        ready_begin_ = 0;
+        min_ready_.clear();
+    }
+
+    /// \b Complexity: O(1)
+    void swap(queue_with_min& q) noexcept(noexcept(std::swap(std::declval<MinListener&>(), std::declval<MinListener&>()))) {
+        using std::swap;
+
+        data_raw_.swap(q.data_raw_);
+        swap(min_raw_, q.min_raw_);
+        swap(raw_scanned_, q.raw_scanned_);
+        data_ready_.swap(q.data_ready_);
+        swap(ready_begin_, q.ready_begin_);
+        min_ready_.swap(q.min_ready_);
+        swap(listener_, q.listener_);
+        swap(tracking_, q.tracking_);
+    }
+};
+
+template <class T, class MinListener, bool Flat>
+inline bool operator==(const queue_with_min<T, MinListener, Flat>& lhs, const queue_with_min<T, MinListener, Flat>& rhs) noexcept {
     return lhs.equal(rhs);
 }
 
+template <class T, class MinListener, bool Flat>
+inline void swap(queue_with_min<T, MinListener, Flat>& lhs, queue_with_min<T, MinListener, Flat>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
 } // namespace examples_v2
 
 #endif // EXAMPLES_QUEUE_WITH_MIN_V2_HPP
@@ -0,0 +1,189 @@
+#ifndef EXAMPLES_SEQLOCK_QUEUE_WITH_MIN_HPP
+#define EXAMPLES_SEQLOCK_QUEUE_WITH_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "queue_with_min_v2.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+
+namespace examples_v2 {
+
+namespace detail {
+
+/**
+Sequence lock for a single writer and any count of readers. Readers only load from the shared
+cache lines, so they never slow down the writer or each other.
+
+Snapshot is copied through relaxed atomic words, so there is no data race even for torn reads that
+are retried.
+*/
+template <class Snapshot>
+class alignas(64) seqlock {
+    static_assert(std::is_trivially_copyable<Snapshot>::value, "Snapshot must be trivially copyable");
+
+    typedef std::size_t word_t;
+    static const std::size_t words_count = (sizeof(Snapshot) + sizeof(word_t) - 1) / sizeof(word_t);
+
+    std::atomic<word_t>     seq_;       // odd while the writer modifies words_
+    std::atomic<word_t>     words_[words_count];
+
+public:
+    seqlock() noexcept
+        : seq_(0)
+    {
+        for (std::size_t i = 0; i < words_count; ++i) {
+            words_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    /// Must be called only by the writer.
+    void store(const Snapshot& s) noexcept {
+        word_t buf[words_count] = {};
+        std::memcpy(buf, &s, sizeof(s));
+
+        const word_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < words_count; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Lock free, may be called from any thread.
+    Snapshot load() const noexcept {
+        word_t buf[words_count];
+        word_t seq;
+        do {
+            do {
+                seq = seq_.load(std::memory_order_acquire);
+            } while (seq & 1);
+
+            for (std::size_t i = 0; i < words_count; ++i) {
+                buf[i] = words_[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (seq_.load(std::memory_order_relaxed) != seq);
+
+        Snapshot s;
+        std::memcpy(&s, buf, sizeof(s));
+        return s;
+    }
+};
+
+} // namespace detail
+
+/// Consistent state of the queue_with_min. min, front and back are value initialized if size is 0.
+template <class T>
+struct queue_with_min_snapshot {
+    T           min;
+    T           front;
+    T           back;
+    std::size_t size;
+};
+
+/**
+queue_with_min for a single writer thread and many reader threads. After each modification the writer
+publishes min(), front(), back() and size() through a seqlock, so readers never block the writer
+and never write to shared memory.
+
+T must be trivially copyable.
+*/
+template <class T>
+class seqlock_queue_with_min {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+    typedef T                               value_type;
+    typedef queue_with_min_snapshot<T>      snapshot_type;
+
+private:
+    queue_with_min<T>                       queue_;
+    detail::seqlock<snapshot_type>          published_;
+
+    void publish() noexcept {
+        snapshot_type s = snapshot_type();
+        s.size = queue_.size();
+        if (s.size) {
+            s.min = queue_.min();
+            s.front = queue_.front();
+            s.back = queue_.back();
+        }
+
+        published_.store(s);
+    }
+
+public:
+    /// \b Complexity: O(1)
+    seqlock_queue_with_min() {
+        publish();
+    }
+
+    seqlock_queue_with_min(const seqlock_queue_with_min&) = delete;
+    seqlock_queue_with_min& operator=(const seqlock_queue_with_min&) = delete;
+
+    // writer
+
+    /// \b Complexity: O(1)
+    void push_back(const value_type& v) {
+        emplace_back(v);
+    }
+
+    /// \b Complexity: O(1)
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        queue_.emplace_back(std::forward<Args>(args)...);
+        publish();
+    }
+
+    /// \b Complexity: same as for queue_with_min::pop_front()
+    void pop_front() {
+        queue_.pop_front();
+        publish();
+    }
+
+    /// \b Complexity: same as for queue_with_min::clear()
+    void clear() noexcept {
+        queue_.clear();
+        publish();
+    }
+
+    /// Access to the underlying queue for the writer thread.
+    const queue_with_min<T>& queue() const noexcept {
+        return queue_;
+    }
+
+    // readers
+
+    /// \b Complexity: O(1), lock free. May be called from any thread.
+    snapshot_type snapshot() const noexcept {
+        return published_.load();
+    }
+
+    /// \b Complexity: O(1), lock free. May be called from any thread.
+    std::size_t size() const noexcept {
+        return snapshot().size;
+    }
+
+    /// \b Complexity: O(1), lock free. May be called from any thread.
+    bool empty() const noexcept {
+        return !size();
+    }
+};
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_SEQLOCK_QUEUE_WITH_MIN_HPP
@@ -0,0 +1,284 @@
+#ifndef EXAMPLES_SHM_QUEUE_WITH_MIN_HPP
+#define EXAMPLES_SHM_QUEUE_WITH_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "seqlock_queue_with_min.hpp"
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+
+namespace examples_v2 {
+
+namespace detail {
+
+/**
+Layout of the shared memory segment: header, then `capacity` elements, then `capacity` offsets
+of the suffix minima. Only offsets are stored, so the segment may be mapped at any address.
+
+The queue is the same two stacks as in queue_with_min, placed in a ring:
+[head, ready_end) are the ready elements, [ready_end, tail) are the raw ones.
+*/
+template <class T>
+struct shm_queue_header {
+    seqlock<queue_with_min_snapshot<T> >    published;
+
+    std::atomic<std::uint32_t>  initialized;
+    std::uint32_t               value_size;
+    std::uint32_t               capacity;
+
+    // writer only state, positions grow monotonically, element index is `position % capacity`
+    std::uint64_t               head;
+    std::uint64_t               ready_end;
+    std::uint64_t               tail;
+    std::uint64_t               min_raw;            // valid if ready_end != tail
+    std::uint32_t               min_ready_size;
+
+    static std::size_t values_offset() noexcept {
+        return (sizeof(shm_queue_header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static std::size_t min_ready_offset(std::uint32_t capacity) noexcept {
+        const std::size_t end = values_offset() + capacity * sizeof(T);
+        return (end + alignof(std::uint32_t) - 1) / alignof(std::uint32_t) * alignof(std::uint32_t);
+    }
+
+    static std::size_t segment_size(std::uint32_t capacity) noexcept {
+        return min_ready_offset(capacity) + capacity * sizeof(std::uint32_t);
+    }
+
+    T* values() noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + values_offset());
+    }
+
+    std::uint32_t* min_ready() noexcept {
+        return reinterpret_cast<std::uint32_t*>(reinterpret_cast<char*>(this) + min_ready_offset(capacity));
+    }
+};
+
+} // namespace detail
+
+/**
+Producer side of a queue_with_min that lives in a POSIX shared memory segment. Elements and the min
+tracking state are stored in the segment, readers from other processes get min(), front(), back() and
+size() through shm_queue_with_min_reader without any syscalls after the segment is mapped.
+
+Only one writer may exist for a segment. The segment is removed by the destructor.
+T must be trivially copyable.
+*/
+template <class T>
+class shm_queue_with_min_writer {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    typedef detail::shm_queue_header<T> header_t;
+
+    std::string                                 name_;
+    boost::interprocess::shared_memory_object   shm_;
+    boost::interprocess::mapped_region          region_;
+    header_t*                                   h_;
+    T*                                          values_;
+    std::uint32_t*                              min_ready_;
+
+    const T& at(std::uint64_t pos) const noexcept {
+        return values_[pos % h_->capacity];
+    }
+
+    void make_ready() noexcept {
+        h_->ready_end = h_->tail;
+        h_->min_ready_size = 0;
+
+        for (std::uint64_t pos = h_->tail; pos != h_->head; --pos) {
+            if (!h_->min_ready_size || at(pos - 1) < values_[min_ready_[h_->min_ready_size - 1]]) {
+                min_ready_[h_->min_ready_size] = static_cast<std::uint32_t>((pos - 1) % h_->capacity);
+                ++ h_->min_ready_size;
+            }
+        }
+    }
+
+    void publish() noexcept {
+        queue_with_min_snapshot<T> s = queue_with_min_snapshot<T>();
+        s.size = size();
+        if (s.size) {
+            s.min = min();
+            s.front = front();
+            s.back = back();
+        }
+
+        h_->published.store(s);
+    }
+
+public:
+    typedef T value_type;
+
+    /// Creates the segment `name` for `capacity` elements. Throws boost::interprocess::interprocess_exception if the segment exists.
+    shm_queue_with_min_writer(const char* name, std::uint32_t capacity)
+        : name_(name)
+        , shm_(boost::interprocess::create_only, name, boost::interprocess::read_write)
+    {
+        try {
+            if (!capacity) {
+                throw std::invalid_argument("examples_v2::shm_queue_with_min_writer: zero capacity");
+            }
+
+            shm_.truncate(header_t::segment_size(capacity));
+            boost::interprocess::mapped_region(shm_, boost::interprocess::read_write).swap(region_);
+        } catch (...) {
+            boost::interprocess::shared_memory_object::remove(name_.c_str());
+            throw;
+        }
+
+        h_ = ::new (region_.get_address()) header_t();
+        h_->value_size = sizeof(T);
+        h_->capacity = capacity;
+        values_ = h_->values();
+        min_ready_ = h_->min_ready();
+
+        publish();
+        h_->initialized.store(1, std::memory_order_release);
+    }
+
+    shm_queue_with_min_writer(const shm_queue_with_min_writer&) = delete;
+    shm_queue_with_min_writer& operator=(const shm_queue_with_min_writer&) = delete;
+
+    ~shm_queue_with_min_writer() {
+        boost::interprocess::shared_memory_object::remove(name_.c_str());
+    }
+
+    /// \b Complexity: O(1). Throws std::length_error if the queue is full.
+    void push_back(const value_type& v) {
+        if (h_->tail - h_->head == h_->capacity) {
+            throw std::length_error("examples_v2::shm_queue_with_min_writer: queue is full");
+        }
+
+        const std::uint64_t pos = h_->tail;
+        values_[pos % h_->capacity] = v;
+        if (h_->ready_end == pos || v < at(h_->min_raw)) {
+            h_->min_raw = pos;
+        }
+        h_->tail = pos + 1;
+
+        publish();
+    }
+
+    /// \b Complexity: amort O(1) [O(N) in worst case].
+    void pop_front() noexcept {
+        assert(!empty());
+
+        if (h_->head == h_->ready_end) {
+            make_ready();
+        }
+
+        if (min_ready_[h_->min_ready_size - 1] == h_->head % h_->capacity) {
+            -- h_->min_ready_size;
+        }
+        ++ h_->head;
+
+        publish();
+    }
+
+    /// \b Complexity: O(1)
+    void clear() noexcept {
+        h_->head = h_->ready_end = h_->tail;
+        h_->min_ready_size = 0;
+
+        publish();
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& front() const noexcept {
+        return at(h_->head);
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& back() const noexcept {
+        return at(h_->tail - 1);
+    }
+
+    /// \b Complexity: O(1)
+    const value_type& min() const noexcept {
+        if (h_->head == h_->ready_end) {
+            return at(h_->min_raw);
+        }
+
+        const value_type& min_ready = values_[min_ready_[h_->min_ready_size - 1]];
+        if (h_->ready_end == h_->tail) {
+            return min_ready;
+        }
+
+        const value_type& min_raw = at(h_->min_raw);
+        return min_raw < min_ready ? min_raw : min_ready;
+    }
+
+    /// \b Complexity: O(1)
+    std::size_t size() const noexcept {
+        return static_cast<std::size_t>(h_->tail - h_->head);
+    }
+
+    /// \b Complexity: O(1)
+    bool empty() const noexcept {
+        return h_->tail == h_->head;
+    }
+
+    /// \b Complexity: O(1)
+    std::size_t capacity() const noexcept {
+        return h_->capacity;
+    }
+};
+
+/// Consumer side of the shm_queue_with_min_writer, may be used from any count of processes and threads.
+template <class T>
+class shm_queue_with_min_reader {
+    typedef detail::shm_queue_header<T> header_t;
+
+    boost::interprocess::shared_memory_object   shm_;
+    boost::interprocess::mapped_region          region_;
+    const header_t*                             h_;
+
+public:
+    typedef T                               value_type;
+    typedef queue_with_min_snapshot<T>      snapshot_type;
+
+    /// Maps the existing segment `name`. Throws std::runtime_error if the segment is not a shm_queue_with_min of T.
+    explicit shm_queue_with_min_reader(const char* name)
+        : shm_(boost::interprocess::open_only, name, boost::interprocess::read_only)
+        , region_(shm_, boost::interprocess::read_only)
+        , h_(static_cast<const header_t*>(region_.get_address()))
+    {
+        if (region_.get_size() < sizeof(header_t)
+            || !h_->initialized.load(std::memory_order_acquire)
+            || h_->value_size != sizeof(T))
+        {
+            throw std::runtime_error("examples_v2::shm_queue_with_min_reader: segment is not initialized or has other type");
+        }
+    }
+
+    /// \b Complexity: O(1), lock free.
+    snapshot_type snapshot() const noexcept {
+        return h_->published.load();
+    }
+
+    /// \b Complexity: O(1), lock free.
+    std::size_t size() const noexcept {
+        return snapshot().size;
+    }
+
+    /// \b Complexity: O(1), lock free.
+    bool empty() const noexcept {
+        return !size();
+    }
+};
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_SHM_QUEUE_WITH_MIN_HPP
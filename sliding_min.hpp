@@ -0,0 +1,272 @@
+#ifndef EXAMPLES_SLIDING_MIN_HPP
+#define EXAMPLES_SLIDING_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+
+#if defined(__cpp_lib_ranges) && __cpp_lib_ranges >= 201911L
+#   include <ranges>
+#   include <iterator>
+#   define EXAMPLES_QUEUE_WITH_MIN_HAS_RANGES
+#endif
+
+
+namespace examples_v2 {
+
+namespace detail {
+
+template <class T>
+inline const T& sliding_min_of(const T& a, const T& b) {
+    return b < a ? b : a;
+}
+
+/**
+van Herk/Gil-Werman step for one block: out[j] = min(in[j], ..., in[j + k - 1]) for j in [0, rem), rem <= k.
+`in` must have k + rem - 1 elements, `prefix` must have k - 1 elements.
+
+Each output costs 3 comparisons independently from k. The last loop is element-wise, so the compiler
+may vectorize it.
+*/
+template <class It, class T>
+void sliding_min_block(It in, std::size_t k, std::size_t rem, T* out, T* prefix) {
+    // suffix minima of in[0, k), only the first rem are outputs
+    std::size_t j = k - 1;
+    T s = in[j];
+    for (; j >= rem; --j) {
+        s = sliding_min_of(static_cast<const T&>(in[j]), s);
+    }
+    for (;; --j) {
+        s = sliding_min_of(static_cast<const T&>(in[j]), s);
+        out[j] = s;
+        if (!j) {
+            break;
+        }
+    }
+
+    if (rem < 2) {
+        return;
+    }
+
+    // prefix minima of in[k, k + rem - 1)
+    prefix[0] = in[k];
+    for (std::size_t i = 1; i + 1 < rem; ++i) {
+        prefix[i] = sliding_min_of(static_cast<const T&>(in[k + i]), prefix[i - 1]);
+    }
+
+    for (std::size_t i = 1; i < rem; ++i) {
+        out[i] = sliding_min_of(out[i], prefix[i - 1]);
+    }
+}
+
+template <class T>
+void sliding_min_chunk(const T* in, std::size_t k, T* out, std::size_t count) {
+    std::vector<T> prefix(k);
+    for (std::size_t b = 0; b < count; b += k) {
+        sliding_min_block(in + b, k, (std::min)(k, count - b), out + b, prefix.data());
+    }
+}
+
+} // namespace detail
+
+/**
+Fixed width sliding minimum: out[i] = min(in[i], ..., in[i + k - 1]) for i in [0, n - k].
+Gives the same values as pushing `in` through queue_with_min and popping after each k-th push,
+if T is strictly weak ordered by operator< (no NaNs).
+
+Input is split into `threads` chunks that are processed in parallel.
+
+\returns Count of the written elements, n - k + 1 or 0 if n < k.
+\throws std::invalid_argument if k is 0.
+
+\b Complexity: O(n), 3 comparisons per element regardless of k.
+*/
+template <class T>
+std::size_t sliding_min(const T* in, std::size_t n, std::size_t k, T* out, unsigned threads = 1) {
+    if (!k) {
+        throw std::invalid_argument("examples_v2::sliding_min: k must be positive");
+    }
+    if (n < k) {
+        return 0;
+    }
+
+    const std::size_t count = n - k + 1;
+    const std::size_t chunks = (std::max)(std::size_t(1), (std::min)(std::size_t(threads), count / k));
+    const std::size_t chunk_size = (count + chunks - 1) / chunks;
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    try {
+        for (std::size_t b = chunk_size; b < count; b += chunk_size) {
+            workers.emplace_back(&detail::sliding_min_chunk<T>, in + b, k, out + b, (std::min)(chunk_size, count - b));
+        }
+        detail::sliding_min_chunk(in, k, out, (std::min)(chunk_size, count));
+    } catch (...) {
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+        throw;
+    }
+
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    return count;
+}
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_RANGES
+
+/// Same as sliding_min(const T*, std::size_t, std::size_t, T*, unsigned) for contiguous ranges. \throws std::length_error if `out` is too small.
+template <std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+std::size_t sliding_min(const In& in, std::size_t k, Out&& out, unsigned threads = 1) {
+    const std::size_t n = std::ranges::size(in);
+    if (k && n >= k && std::ranges::size(out) < n - k + 1) {
+        throw std::length_error("examples_v2::sliding_min: output range is too small");
+    }
+
+    return sliding_min(std::ranges::data(in), n, k, std::ranges::data(out), threads);
+}
+
+/**
+Lazy single pass view of the fixed width sliding minimum over a random access range.
+Values are computed by blocks of k with the van Herk/Gil-Werman algorithm, so only O(k) memory is used.
+*/
+template <std::ranges::view V>
+    requires std::ranges::random_access_range<V> && std::ranges::sized_range<V>
+class sliding_min_view: public std::ranges::view_interface<sliding_min_view<V> > {
+    typedef std::ranges::range_value_t<V> value_t;
+
+    V                       base_;
+    std::size_t             k_;
+    std::size_t             count_;
+    std::size_t             block_begin_;
+    std::vector<value_t>    block_;
+    std::vector<value_t>    prefix_;
+
+    void compute_block(std::size_t b) {
+        block_begin_ = b;
+        detail::sliding_min_block(
+            std::ranges::begin(base_) + static_cast<std::ranges::range_difference_t<V> >(b),
+            k_, (std::min)(k_, count_ - b), block_.data(), prefix_.data()
+        );
+    }
+
+public:
+    class iterator {
+        sliding_min_view*   parent_;
+        std::size_t         i_;
+
+    public:
+        typedef std::input_iterator_tag iterator_concept;
+        typedef value_t                 value_type;
+        typedef std::ptrdiff_t          difference_type;
+
+        iterator() = default;
+
+        iterator(sliding_min_view* parent, std::size_t i) noexcept
+            : parent_(parent)
+            , i_(i)
+        {}
+
+        const value_type& operator*() const {
+            return parent_->block_[i_ - parent_->block_begin_];
+        }
+
+        iterator& operator++() {
+            ++ i_;
+            if (i_ < parent_->count_ && i_ - parent_->block_begin_ == parent_->k_) {
+                parent_->compute_block(i_);
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++ *this;
+        }
+
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return i_ == parent_->count_;
+        }
+    };
+
+    sliding_min_view(V base, std::size_t k)
+        : base_(std::move(base))
+        , k_(k)
+        , count_(0)
+        , block_begin_(0)
+    {
+        if (!k_) {
+            throw std::invalid_argument("examples_v2::sliding_min_view: k must be positive");
+        }
+
+        const std::size_t n = std::ranges::size(base_);
+        count_ = (n < k_ ? 0 : n - k_ + 1);
+    }
+
+    /// May be called only once.
+    iterator begin() {
+        block_.resize(k_);
+        prefix_.resize(k_);
+        if (count_) {
+            compute_block(0);
+        }
+
+        return iterator(this, 0);
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return std::default_sentinel;
+    }
+
+    std::size_t size() const noexcept {
+        return count_;
+    }
+};
+
+template <class R>
+sliding_min_view(R&&, std::size_t) -> sliding_min_view<std::views::all_t<R> >;
+
+namespace views {
+
+namespace detail {
+
+struct sliding_min_closure {
+    std::size_t k;
+
+    template <std::ranges::viewable_range R>
+    friend auto operator|(R&& r, const sliding_min_closure& c) {
+        return sliding_min_view(std::views::all(std::forward<R>(r)), c.k);
+    }
+};
+
+struct sliding_min_fn {
+    template <std::ranges::viewable_range R>
+    auto operator()(R&& r, std::size_t k) const {
+        return sliding_min_view(std::views::all(std::forward<R>(r)), k);
+    }
+
+    sliding_min_closure operator()(std::size_t k) const noexcept {
+        return sliding_min_closure{k};
+    }
+};
+
+} // namespace detail
+
+/// `range | examples_v2::views::sliding_min(k)` or `examples_v2::views::sliding_min(range, k)`
+inline constexpr detail::sliding_min_fn sliding_min;
+
+} // namespace views
+
+#endif // EXAMPLES_QUEUE_WITH_MIN_HAS_RANGES
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_SLIDING_MIN_HPP
@@ -261,8 +261,41 @@ TEST(qwm, move_and_copy2) {
 
 }
 
+TEST(qwm, swap) {
+    queue_with_min<int> q1({3, 1, 2});
+    queue_with_min<int> q2;
+
+    swap(q1, q2);
+    ASSERT_TRUE(q1.empty());
+    ASSERT_TRUE(q2.size() == 3);
+    ASSERT_TRUE(q2.min() == 1);
+
+    q1.push_back(5);
+    ASSERT_TRUE(q1.min() == 5);
+    q2.pop_front();
+    q2.pop_front();
+    ASSERT_TRUE(q2.min() == 2);
+
+    q1.swap(q2);
+    ASSERT_TRUE(q1.min() == 2);
+    ASSERT_TRUE(q2.min() == 5);
+
+    queue_with_min<int> q3(std::move(q1));
+    ASSERT_TRUE(q1.empty());
+    q1.push_back(7);
+    ASSERT_TRUE(q1.min() == 7);
+    ASSERT_TRUE(q3.min() == 2);
+
+    q3 = std::move(q1);
+    ASSERT_TRUE(q1.empty());
+    q1.push_front(0);
+    ASSERT_TRUE(q1.min() == 0);
+    ASSERT_TRUE(q3.min() == 7);
+}
+
 TEST(qwm, noexcepts) {
     ASSERT_TRUE( std::is_nothrow_constructible<queue_with_min<int> >() );
-    //ASSERT_TRUE( std::is_nothrow_move_assignable<queue_with_min<int> >() );
-    //ASSERT_TRUE( std::is_nothrow_move_constructible<queue_with_min<int> >() );
+    ASSERT_TRUE( std::is_nothrow_move_assignable<queue_with_min<int> >() );
+    ASSERT_TRUE( std::is_nothrow_move_constructible<queue_with_min<int> >() );
+    ASSERT_TRUE( noexcept(swap(std::declval<queue_with_min<int>&>(), std::declval<queue_with_min<int>&>())) );
 }
@@ -0,0 +1,84 @@
+#include "bucketed_queue_with_min.hpp"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+
+TEST(bqwm, basic) {
+    bucketed_queue_with_min<int> q(3);
+    ASSERT_TRUE(q.empty());
+    ASSERT_TRUE(q.error_bound() == 2);
+    ASSERT_THROW(bucketed_queue_with_min<int>(0), std::invalid_argument);
+
+    q.push_back(5, 10);
+    q.push_back(2, 11);
+    ASSERT_TRUE(q.min() == 2);
+    ASSERT_TRUE(q.buckets_count() == 1);
+
+    q.push_back(7, 12);
+    q.push_back(4, 13);
+    ASSERT_TRUE(q.size() == 4);
+    ASSERT_TRUE(q.buckets_count() == 2);
+    ASSERT_TRUE(q.min() == 2);
+    ASSERT_TRUE(q.front_bucket().count == 3);
+    ASSERT_TRUE(q.front_bucket().min == 2);
+    ASSERT_TRUE(q.oldest_timestamp() == 10);
+    ASSERT_TRUE(q.back_timestamp() == 13);
+
+    // bucket [10, 12] is not expired by 11
+    q.expire_before(11);
+    ASSERT_TRUE(q.size() == 4);
+    ASSERT_TRUE(q.min() == 2);
+
+    q.expire_before(13);
+    ASSERT_TRUE(q.size() == 1);
+    ASSERT_TRUE(q.min() == 4);
+    ASSERT_TRUE(q.oldest_timestamp() == 13);
+
+    q.pop_front();
+    ASSERT_TRUE(q.empty());
+
+    q.push_back(1, 20);
+    q.clear();
+    ASSERT_TRUE(q.empty());
+    ASSERT_TRUE(q.buckets_count() == 0);
+}
+
+TEST(bqwm, horizon) {
+    const std::size_t bucket_sizes[] = {1, 2, 7, 64};
+    const std::size_t horizons[] = {1, 5, 100, 1000};
+
+    for (std::size_t b = 0; b < sizeof(bucket_sizes) / sizeof(bucket_sizes[0]); ++b) {
+        for (std::size_t h = 0; h < sizeof(horizons) / sizeof(horizons[0]); ++h) {
+            bucketed_queue_with_min<int, std::size_t> q(bucket_sizes[b], horizons[h]);
+            queue_with_min<int> accounted;  // exactly the elements accounted by q
+            queue_with_min<int> exact;      // exact window of the last horizons[h] elements
+
+            for (std::size_t i = 0; i < 1500; ++i) {
+                const int v = std::rand() % 10000;
+                q.push_back(v, i);
+                accounted.push_back(v);
+                exact.push_back(v);
+                if (exact.size() > horizons[h]) {
+                    exact.pop_front();
+                }
+
+                ASSERT_TRUE(q.size() >= exact.size());
+                ASSERT_TRUE(q.size() <= exact.size() + q.error_bound());
+                while (accounted.size() > q.size()) {
+                    accounted.pop_front();
+                }
+
+                ASSERT_TRUE(q.buckets_count() <= horizons[h] / bucket_sizes[b] + 2);
+                ASSERT_TRUE(q.oldest_timestamp() == i + 1 - q.size());
+
+                // min over exactly the accounted elements, not above the exact window min
+                ASSERT_TRUE(q.min() == accounted.min());
+                ASSERT_TRUE(q.min() <= exact.min());
+            }
+        }
+    }
+}
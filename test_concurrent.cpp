@@ -0,0 +1,191 @@
+#include "concurrent_queue_with_min.hpp"
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+
+TEST(cqwm, basic) {
+    concurrent_queue_with_min<int> q;
+    ASSERT_TRUE(q.size() == 0);
+    ASSERT_TRUE(q.empty());
+
+    int v = 0;
+    ASSERT_FALSE(q.try_pop(v));
+    ASSERT_FALSE(q.try_min(v));
+
+    q.push_back(3);
+    q.push_back(1);
+    q.push_back(2);
+    ASSERT_TRUE(q.size() == 3);
+    ASSERT_TRUE(q.try_min(v));
+    ASSERT_TRUE(v == 1);
+
+    ASSERT_TRUE(q.wait_pop() == 3);
+    ASSERT_TRUE(q.try_pop(v));
+    ASSERT_TRUE(v == 1);
+    ASSERT_TRUE(q.try_min(v));
+    ASSERT_TRUE(v == 2);
+}
+
+TEST(cqwm, wait_pop) {
+    concurrent_queue_with_min<int> q;
+    const int values_count = 1000;
+
+    std::thread producer([&q]() {
+        for (int i = 0; i < values_count; ++i) {
+            q.push_back(i);
+        }
+    });
+
+    for (int i = 0; i < values_count; ++i) {
+        ASSERT_TRUE(q.wait_pop() == i);
+    }
+
+    producer.join();
+    ASSERT_TRUE(q.empty());
+}
+
+TEST(cqwm, wait_min_below) {
+    concurrent_queue_with_min<int> q;
+    q.push_back(100);
+
+    std::thread producer([&q]() {
+        for (int i = 99; i > 0; --i) {
+            q.push_back(i);
+        }
+    });
+
+    ASSERT_TRUE(q.wait_min_below(10) < 10);
+    producer.join();
+    ASSERT_TRUE(q.wait_min_below(2) == 1);
+}
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_COROUTINES
+
+namespace {
+
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+detached_task consume(concurrent_queue_with_min<int>& q, std::vector<int>& out, int count) {
+    for (int i = 0; i < count; ++i) {
+        out.push_back(co_await q.async_pop());
+    }
+}
+
+struct throws_on_negative {
+    int v;
+
+    explicit throws_on_negative(int value)
+        : v(value)
+    {
+        if (v < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+
+    bool operator<(const throws_on_negative& rhs) const noexcept {
+        return v < rhs.v;
+    }
+};
+
+detached_task consume_one(concurrent_queue_with_min<throws_on_negative>& q, int& out) {
+    out = (co_await q.async_pop()).v;
+}
+
+struct owned_task {
+    struct promise_type {
+        owned_task get_return_object() noexcept { return owned_task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit owned_task(std::coroutine_handle<promise_type> h) noexcept
+        : handle(h)
+    {}
+
+    owned_task(const owned_task&) = delete;
+    owned_task& operator=(const owned_task&) = delete;
+
+    ~owned_task() {
+        handle.destroy();
+    }
+};
+
+owned_task consume_owned(concurrent_queue_with_min<int>& q, std::vector<int>& out) {
+    out.push_back(co_await q.async_pop());
+}
+
+} // anonymous namespace
+
+TEST(cqwm, async_pop_throwing_value) {
+    concurrent_queue_with_min<throws_on_negative> q;
+    int out = 0;
+
+    consume_one(q, out);
+    ASSERT_THROW(q.emplace_back(-1), std::runtime_error);
+    ASSERT_TRUE(q.empty());
+
+    // the consumer is still waiting
+    q.emplace_back(5);
+    ASSERT_TRUE(out == 5);
+    ASSERT_TRUE(q.empty());
+}
+
+TEST(cqwm, async_pop_destroyed_coroutine) {
+    concurrent_queue_with_min<int> q;
+    std::vector<int> out;
+
+    {
+        owned_task t = consume_owned(q, out);
+    }
+
+    q.push_back(1);
+    ASSERT_TRUE(out.empty());
+    ASSERT_TRUE(q.size() == 1);
+
+    {
+        owned_task t = consume_owned(q, out);
+        ASSERT_TRUE((out == std::vector<int>{1}));
+    }
+    ASSERT_TRUE(q.empty());
+}
+
+TEST(cqwm, async_pop) {
+    concurrent_queue_with_min<int> q;
+    std::vector<int> out;
+
+    q.push_back(10);
+    consume(q, out, 3);
+    ASSERT_TRUE((out == std::vector<int>{10}));
+
+    q.push_back(20);
+    ASSERT_TRUE((out == std::vector<int>{10, 20}));
+    ASSERT_TRUE(q.empty());
+
+    q.push_back(30);
+    ASSERT_TRUE((out == std::vector<int>{10, 20, 30}));
+
+    q.push_back(40);
+    ASSERT_TRUE((out == std::vector<int>{10, 20, 30}));
+    ASSERT_TRUE(q.size() == 1);
+}
+
+#endif
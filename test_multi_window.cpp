@@ -0,0 +1,62 @@
+#include "multi_window_min.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+
+TEST(mwm, basic) {
+    multi_window_min<int> w({1, 3});
+    ASSERT_TRUE(w.empty());
+    ASSERT_TRUE(w.horizons_count() == 2);
+    ASSERT_TRUE(w.horizon(1) == 3);
+
+    w.push_back(5);
+    ASSERT_TRUE(w.min(0) == 5);
+    ASSERT_TRUE(w.min(1) == 5);
+
+    w.push_back(7);
+    w.push_back(6);
+    ASSERT_TRUE(w.size(0) == 1);
+    ASSERT_TRUE(w.size(1) == 3);
+    ASSERT_TRUE(w.min(0) == 6);
+    ASSERT_TRUE(w.min(1) == 5);
+    ASSERT_TRUE(w.front(1) == 5);
+    ASSERT_TRUE(w.back() == 6);
+
+    w.push_back(8);
+    ASSERT_TRUE(w.min(0) == 8);
+    ASSERT_TRUE(w.min(1) == 6);
+    ASSERT_TRUE(w.front(1) == 7);
+
+    w.clear();
+    ASSERT_TRUE(w.empty());
+    w.push_back(9);
+    ASSERT_TRUE(w.min(1) == 9);
+    ASSERT_TRUE(w.size(1) == 1);
+
+    ASSERT_THROW(multi_window_min<int>({1, 0}), std::invalid_argument);
+    ASSERT_THROW(multi_window_min<int>({}), std::invalid_argument);
+}
+
+TEST(mwm, random) {
+    const std::size_t horizons[] = {1, 2, 7, 60, 64};
+    multi_window_min<unsigned int> w(horizons, horizons + 5);
+    std::vector<unsigned int> v;
+
+    for (std::size_t i = 0; i < 3000; ++i) {
+        v.push_back(std::rand() % 1000);
+        w.push_back(v.back());
+
+        for (std::size_t h = 0; h < w.horizons_count(); ++h) {
+            const std::size_t count = (std::min)(v.size(), horizons[h]);
+            ASSERT_TRUE(w.size(h) == count);
+            ASSERT_TRUE(w.front(h) == v[v.size() - count]);
+            ASSERT_TRUE(w.min(h) == *std::min_element(v.end() - count, v.end()));
+        }
+    }
+}
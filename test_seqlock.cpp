@@ -0,0 +1,75 @@
+#include "seqlock_queue_with_min.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+
+TEST(sqwm, basic) {
+    seqlock_queue_with_min<int> q;
+    ASSERT_TRUE(q.size() == 0);
+    ASSERT_TRUE(q.empty());
+
+    q.push_back(3);
+    q.push_back(1);
+    q.push_back(2);
+
+    queue_with_min_snapshot<int> s = q.snapshot();
+    ASSERT_TRUE(s.size == 3);
+    ASSERT_TRUE(s.min == 1);
+    ASSERT_TRUE(s.front == 3);
+    ASSERT_TRUE(s.back == 2);
+
+    q.pop_front();
+    q.pop_front();
+    s = q.snapshot();
+    ASSERT_TRUE(s.size == 1);
+    ASSERT_TRUE(s.min == 2);
+    ASSERT_TRUE(s.front == 2);
+    ASSERT_TRUE(s.back == 2);
+    ASSERT_TRUE(q.queue().min() == 2);
+
+    q.clear();
+    ASSERT_TRUE(q.empty());
+}
+
+TEST(sqwm, consistent_snapshots) {
+    seqlock_queue_with_min<unsigned long> q;
+    const unsigned long values_count = 100000;
+    const std::size_t window = 16;
+
+    std::vector<std::thread> readers;
+    std::vector<char> failed(4, 0);
+    for (std::size_t r = 0; r < failed.size(); ++r) {
+        readers.emplace_back([&q, &failed, r, values_count]() {
+            unsigned long last_back = 0;
+            do {
+                const queue_with_min_snapshot<unsigned long> s = q.snapshot();
+                if (!s.size) {
+                    continue;
+                }
+
+                // increasing values in the window: min is the front
+                if (s.min != s.front || s.back - s.front + 1 != s.size || s.back < last_back) {
+                    failed[r] = 1;
+                }
+                last_back = s.back;
+            } while (last_back != values_count);
+        });
+    }
+
+    for (unsigned long i = 1; i <= values_count; ++i) {
+        q.push_back(i);
+        if (q.queue().size() > window) {
+            q.pop_front();
+        }
+    }
+
+    for (std::size_t r = 0; r < readers.size(); ++r) {
+        readers[r].join();
+        ASSERT_FALSE(failed[r]);
+    }
+}
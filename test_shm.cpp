@@ -0,0 +1,145 @@
+#include "shm_queue_with_min.hpp"
+
+#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+namespace {
+
+// Unique for each process, so parallel test runs do not collide
+const std::string segment_name_storage = "examples_qwm_test_shm_" + std::to_string(::getpid());
+const char* const segment_name = segment_name_storage.c_str();
+
+} // anonymous namespace
+
+
+TEST(shmqwm, basic) {
+    boost::interprocess::shared_memory_object::remove(segment_name);
+    shm_queue_with_min_writer<int> w(segment_name, 4);
+    shm_queue_with_min_reader<int> r(segment_name);
+    ASSERT_TRUE(w.empty());
+    ASSERT_TRUE(r.empty());
+    ASSERT_TRUE(w.capacity() == 4);
+
+    w.push_back(3);
+    w.push_back(1);
+    w.push_back(2);
+    queue_with_min_snapshot<int> s = r.snapshot();
+    ASSERT_TRUE(s.size == 3);
+    ASSERT_TRUE(s.min == 1);
+    ASSERT_TRUE(s.front == 3);
+    ASSERT_TRUE(s.back == 2);
+
+    w.push_back(5);
+    ASSERT_THROW(w.push_back(6), std::length_error);
+
+    w.pop_front();
+    w.pop_front();
+    w.push_back(0);
+    s = r.snapshot();
+    ASSERT_TRUE(s.size == 3);
+    ASSERT_TRUE(s.min == 0);
+    ASSERT_TRUE(s.front == 2);
+    ASSERT_TRUE(s.back == 0);
+
+    w.clear();
+    ASSERT_TRUE(r.empty());
+}
+
+TEST(shmqwm, random) {
+    boost::interprocess::shared_memory_object::remove(segment_name);
+    shm_queue_with_min_writer<unsigned int> w(segment_name, 64);
+    shm_queue_with_min_reader<unsigned int> r(segment_name);
+    std::deque<unsigned int> v;
+
+    for (std::size_t i = 0; i < 10000; ++i) {
+        if (v.size() < w.capacity() && (v.empty() || std::rand() % 3)) {
+            v.push_back(std::rand() % 1000);
+            w.push_back(v.back());
+        } else {
+            v.pop_front();
+            w.pop_front();
+        }
+
+        const queue_with_min_snapshot<unsigned int> s = r.snapshot();
+        ASSERT_TRUE(s.size == v.size());
+        if (!v.empty()) {
+            ASSERT_TRUE(s.min == *std::min_element(v.cbegin(), v.cend()));
+            ASSERT_TRUE(s.front == v.front());
+            ASSERT_TRUE(s.back == v.back());
+        }
+    }
+}
+
+TEST(shmqwm, errors) {
+    boost::interprocess::shared_memory_object::remove(segment_name);
+    ASSERT_THROW(shm_queue_with_min_reader<int> r(segment_name), boost::interprocess::interprocess_exception);
+
+    shm_queue_with_min_writer<int> w(segment_name, 4);
+    ASSERT_THROW((shm_queue_with_min_writer<int>(segment_name, 4)), boost::interprocess::interprocess_exception);
+    ASSERT_THROW(shm_queue_with_min_reader<double> r(segment_name), std::runtime_error);
+}
+
+TEST(shmqwm, other_process) {
+    boost::interprocess::shared_memory_object::remove(segment_name);
+    shm_queue_with_min_writer<unsigned long> w(segment_name, 16);
+    const unsigned long values_count = 200000;
+
+    const pid_t pid = ::fork();
+    ASSERT_TRUE(pid != -1);
+    if (!pid) {
+        // The inherited mapping of the writer occupies its address, so the reader segment is mapped
+        // at another address of the child process.
+        int res = 0;
+        try {
+            shm_queue_with_min_reader<unsigned long> r(segment_name);
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+            unsigned long last_back = 0;
+            while (last_back != values_count) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    res = 2;
+                    break;
+                }
+
+                const queue_with_min_snapshot<unsigned long> s = r.snapshot();
+                if (!s.size) {
+                    continue;
+                }
+
+                // increasing values in the window: min is the front
+                if (s.min != s.front || s.back - s.front + 1 != s.size || s.back < last_back) {
+                    res = 1;
+                    break;
+                }
+                last_back = s.back;
+            }
+        } catch (...) {
+            res = 3;
+        }
+
+        ::_exit(res);
+    }
+
+    for (unsigned long i = 1; i <= values_count; ++i) {
+        if (w.size() == w.capacity()) {
+            w.pop_front();
+        }
+        w.push_back(i);
+    }
+
+    int status = 0;
+    ASSERT_TRUE(::waitpid(pid, &status, 0) == pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
@@ -0,0 +1,110 @@
+#include "sliding_min.hpp"
+#include "queue_with_min_v2.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+namespace {
+
+template <class T>
+std::vector<T> reference_sliding_min(const std::vector<T>& in, std::size_t k) {
+    std::vector<T> res;
+    queue_with_min<T> q;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        q.push_back(in[i]);
+        if (q.size() == k) {
+            res.push_back(q.min());
+            q.pop_front();
+        }
+    }
+
+    return res;
+}
+
+template <class T>
+std::vector<T> random_values(std::size_t n) {
+    std::vector<T> res;
+    for (std::size_t i = 0; i < n; ++i) {
+        res.push_back(static_cast<T>(std::rand() % 1000) / static_cast<T>(7));
+    }
+
+    return res;
+}
+
+template <class T>
+void check_sliding_min() {
+    const std::size_t widths[] = {1, 2, 3, 5, 16, 100, 999};
+    const std::size_t sizes[] = {0, 1, 2, 17, 100, 1000, 3001};
+    const unsigned threads[] = {1, 3, 8};
+
+    for (std::size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+        for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            const std::vector<T> in = random_values<T>(sizes[s]);
+            const std::vector<T> expected = reference_sliding_min(in, widths[w]);
+
+            for (std::size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t) {
+                std::vector<T> out(in.size() + 1, T(-1));
+                const std::size_t count = sliding_min(in.data(), in.size(), widths[w], out.data(), threads[t]);
+                ASSERT_EQ(count, expected.size());
+                ASSERT_TRUE(std::equal(expected.begin(), expected.end(), out.begin()));
+                ASSERT_EQ(out[count], T(-1));
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+TEST(sliding_min, matches_queue_with_min) {
+    check_sliding_min<int>();
+    check_sliding_min<double>();
+}
+
+TEST(sliding_min, edge_cases) {
+    const int in[] = {5, 3, 4, 1, 2};
+    int out[5] = {};
+
+    ASSERT_THROW(sliding_min(in, 5, 0, out), std::invalid_argument);
+    ASSERT_EQ(sliding_min(in, 5, 6, out), 0u);
+
+    ASSERT_EQ(sliding_min(in, 5, 5, out), 1u);
+    ASSERT_EQ(out[0], 1);
+
+    ASSERT_EQ(sliding_min(in, 5, 2, out), 4u);
+    ASSERT_EQ(out[0], 3);
+    ASSERT_EQ(out[1], 3);
+    ASSERT_EQ(out[2], 1);
+    ASSERT_EQ(out[3], 1);
+}
+
+#ifdef EXAMPLES_QUEUE_WITH_MIN_HAS_RANGES
+TEST(sliding_min, ranges) {
+    const std::vector<int> in = random_values<int>(1000);
+    const std::vector<int> expected = reference_sliding_min(in, 7);
+
+    std::vector<int> out(expected.size());
+    ASSERT_EQ(sliding_min(in, 7, out), expected.size());
+    ASSERT_EQ(out, expected);
+
+    std::vector<int> too_small(expected.size() - 1);
+    ASSERT_THROW(sliding_min(in, 7, too_small), std::length_error);
+
+    std::vector<int> lazy;
+    for (int v : in | views::sliding_min(7)) {
+        lazy.push_back(v);
+    }
+    ASSERT_EQ(lazy, expected);
+
+    auto view = views::sliding_min(in, 1000);
+    ASSERT_EQ(view.size(), 1u);
+    ASSERT_EQ(*view.begin(), *std::min_element(in.begin(), in.end()));
+
+    ASSERT_TRUE(std::ranges::empty(views::sliding_min(in, 1001)));
+}
+#endif
@@ -0,0 +1,108 @@
+#include "trace_queue_with_min.hpp"
+#include "queue_with_min_v1.hpp"
+#include "queue_with_min_v2.hpp"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace examples_v2;
+
+
+TEST(trace, record_and_read) {
+    std::stringstream ss;
+    {
+        traced_queue_with_min<queue_with_min<int> > q(ss);
+        q.push_back(3);
+        q.emplace_back(1);
+        ASSERT_EQ(q.min(), 1);
+        q.pop_front();
+        ASSERT_EQ(q.front(), 1);
+        ASSERT_EQ(q.size(), 1u);
+        q.clear();
+        ASSERT_TRUE(q.empty());
+        q.push_back(-7);
+    }
+
+    const trace_header h = read_trace_header(ss);
+    ASSERT_EQ(h.value_size, sizeof(int));
+    ASSERT_TRUE(h.kind == trace_value_kind::signed_integer);
+
+    ss.seekg(0);
+    const std::vector<trace_record<int> > trace = read_trace<int>(ss);
+    ASSERT_EQ(trace.size(), 6u);
+    ASSERT_TRUE(trace[0].op == trace_op::push_back);
+    ASSERT_EQ(trace[0].value, 3);
+    ASSERT_TRUE(trace[1].op == trace_op::push_back);
+    ASSERT_EQ(trace[1].value, 1);
+    ASSERT_TRUE(trace[2].op == trace_op::min);
+    ASSERT_TRUE(trace[3].op == trace_op::pop_front);
+    ASSERT_TRUE(trace[4].op == trace_op::clear);
+    ASSERT_TRUE(trace[5].op == trace_op::push_back);
+    ASSERT_EQ(trace[5].value, -7);
+}
+
+TEST(trace, invalid_traces) {
+    std::stringstream not_trace("not a trace at all");
+    ASSERT_THROW(read_trace<int>(not_trace), std::runtime_error);
+
+    std::stringstream other_type;
+    {
+        traced_queue_with_min<queue_with_min<double> > q(other_type);
+        q.push_back(1.0);
+    }
+    ASSERT_THROW(read_trace<long long>(other_type), std::runtime_error);
+
+    std::stringstream pop_empty;
+    trace_writer<int> w(pop_empty);
+    w.write_push_back(1);
+    w.write(trace_op::pop_front);
+    w.write(trace_op::min);
+    ASSERT_THROW(read_trace<int>(pop_empty), std::runtime_error);
+
+    std::stringstream truncated;
+    trace_writer<int> w2(truncated);
+    w2.write_push_back(1);
+    const std::string data = truncated.str();
+    std::stringstream truncated2(data.substr(0, data.size() - 1));
+    ASSERT_THROW(read_trace<int>(truncated2), std::runtime_error);
+}
+
+TEST(trace, replay) {
+    std::stringstream ss;
+    {
+        traced_queue_with_min<queue_with_min<unsigned> > q(ss);
+        for (unsigned i = 0; i < 1000; ++i) {
+            q.push_back((i * 7919) % 1000);
+            if (q.size() > 100) {
+                q.pop_front();
+            }
+            if (i % 10 == 0) {
+                q.min();
+            }
+            if (i % 500 == 499) {
+                q.clear();
+            }
+        }
+    }
+
+    const std::vector<trace_record<unsigned> > trace = read_trace<unsigned>(ss);
+
+    const replay_result r1 = replay_trace<examples_v1::queue_with_min<unsigned> >(trace, 2);
+    const replay_result r2 = replay_trace<queue_with_min<unsigned, null_min_listener, false> >(trace);
+    const replay_result r3 = replay_trace<queue_with_min<unsigned> >(trace);
+
+    const replay_result* results[] = {&r1, &r2, &r3};
+    for (std::size_t i = 0; i < 3; ++i) {
+        const replay_result& r = *results[i];
+        ASSERT_EQ(r.ops, trace.size());
+        ASSERT_EQ(r.per_op[static_cast<std::size_t>(trace_op::push_back)].count, 1000u);
+        ASSERT_EQ(r.per_op[static_cast<std::size_t>(trace_op::pop_front)].count, 800u);
+        ASSERT_EQ(r.per_op[static_cast<std::size_t>(trace_op::min)].count, 100u);
+        ASSERT_EQ(r.per_op[static_cast<std::size_t>(trace_op::clear)].count, 2u);
+        ASSERT_LE(r.per_op[0].p50_ns, r.per_op[0].max_ns);
+        ASSERT_GE(r.timer_overhead_ns, 0);
+        ASSERT_GE(r.per_op[0].p50_ns, 0);
+    }
+}
@@ -2,11 +2,23 @@
 
 #include <memory>
 #include <deque>
+#include <vector>
+#include <array>
+#include <limits>
+#include <cstdlib>
 
 #include "gtest/gtest.h"
 
 using namespace examples_v2;
 
+struct min_history {
+    std::vector<int>* history;
+
+    void operator()(int new_min) const {
+        history->push_back(new_min);
+    }
+};
+
 
 TEST(qwm2, basic) {
     queue_with_min<int> q;
@@ -119,6 +131,374 @@ TEST(qwm2, min_random) {
     ASSERT_TRUE(q.empty());
 }
 
+TEST(qwm2, min_random_list_storage) {
+    const std::size_t values_count = 500;
+
+    std::deque<int> v(values_count);
+    std::generate(v.begin(), v.end(), std::rand);
+
+    queue_with_min<int, null_min_listener, false> q_list(v.begin(), v.end());
+    queue_with_min<int> q_flat(v.begin(), v.end());
+
+    for (std::size_t i = 0; i < values_count; ++i) {
+        ASSERT_TRUE(q_list.min() == q_flat.min());
+        ASSERT_TRUE(q_list.front() == q_flat.front());
+        ASSERT_TRUE(q_list.back() == q_flat.back());
+        ASSERT_TRUE(q_list.size() == q_flat.size());
+
+        q_list.pop_front();
+        q_flat.pop_front();
+        if (i % 3 == 0) {
+            q_list.push_back(v[i] / 2);
+            q_flat.push_back(v[i] / 2);
+        }
+    }
+}
+
+template <bool Flat>
+void test_lazy_min_tracking() {
+    const std::size_t values_count = 500;
+
+    std::vector<int> v(values_count);
+    std::generate(v.begin(), v.end(), std::rand);
+
+    queue_with_min<int, null_min_listener, Flat> q_eager;
+    queue_with_min<int, null_min_listener, Flat> q_lazy;
+    q_lazy.set_min_tracking(min_tracking::lazy);
+    ASSERT_TRUE(q_lazy.get_min_tracking() == min_tracking::lazy);
+
+    q_eager.push_back(0);
+    q_lazy.push_back(0);
+    for (std::size_t i = 0; i < values_count; ++i) {
+        q_eager.push_back(v[i]);
+        q_lazy.push_back(v[i]);
+
+        if (i % 7 == 0) {
+            ASSERT_TRUE(q_lazy.min() == q_eager.min());
+        }
+        if (i % 3 == 0) {
+            q_eager.pop_front();
+            q_lazy.pop_front();
+            ASSERT_TRUE(q_lazy.min() == q_eager.min());
+        }
+        if (i % 101 == 0) {
+            q_lazy.set_min_tracking(min_tracking::eager);
+            ASSERT_TRUE(q_lazy.min() == q_eager.min());
+            q_lazy.push_back(v[i] + 1);
+            q_eager.push_back(v[i] + 1);
+            q_lazy.set_min_tracking(min_tracking::lazy);
+        }
+    }
+
+    ASSERT_TRUE(q_lazy == q_eager);
+    while (!q_eager.empty()) {
+        ASSERT_TRUE(q_lazy.min() == q_eager.min());
+        q_eager.pop_front();
+        q_lazy.pop_front();
+    }
+    ASSERT_TRUE(q_lazy.empty());
+}
+
+TEST(qwm2, lazy_min_tracking) {
+    test_lazy_min_tracking<true>();
+    test_lazy_min_tracking<false>();
+
+    std::vector<int> history;
+    queue_with_min<int, min_history> q(min_history{&history});
+    q.set_min_tracking(min_tracking::lazy);
+    ASSERT_TRUE(q.get_min_tracking() == min_tracking::eager);
+}
+
+template <class Queue>
+void check_queue(Queue& q, std::deque<int>& v) {
+    ASSERT_TRUE(q.size() == v.size());
+    while (!v.empty()) {
+        ASSERT_TRUE(q.front() == v.front());
+        ASSERT_TRUE(q.back() == v.back());
+        ASSERT_TRUE(q.min() == *std::min_element(v.cbegin(), v.cend()));
+        q.pop_front();
+        v.pop_front();
+    }
+    ASSERT_TRUE(q.empty());
+}
+
+template <bool Flat>
+void test_append_split() {
+    typedef queue_with_min<int, min_history, Flat> queue_t;
+    std::vector<int> history;
+
+    for (std::size_t n = 0; n <= 12; ++n) {
+        std::deque<int> v1, v2;
+        queue_t q1(min_history{&history});
+        queue_t q2(min_history{&history});
+        for (int i = 0; i < 6; ++i) {
+            v1.push_back(std::rand() % 100);
+            q1.push_back(v1.back());
+            v2.push_back(std::rand() % 100);
+            q2.push_back(v2.back());
+        }
+
+        // making the ready parts non empty
+        q1.pop_front();
+        v1.pop_front();
+        q1.push_back(42);
+        v1.push_back(42);
+        q2.pop_front();
+        v2.pop_front();
+        q2.push_back(7);
+        v2.push_back(7);
+
+        history.clear();
+        const int expected_min = std::min(q1.min(), q2.min());
+        const bool min_changed = (q2.min() < q1.min());
+        q1.append(std::move(q2));
+        v1.insert(v1.end(), v2.begin(), v2.end());
+        ASSERT_TRUE(q2.empty());
+        ASSERT_TRUE(q1.size() == 12);
+        ASSERT_TRUE(q1.min() == expected_min);
+        ASSERT_TRUE(history == (min_changed ? std::vector<int>{expected_min} : std::vector<int>{}));
+
+        queue_t tail = q1.split_at(n);
+        std::deque<int> v_tail(v1.begin() + n, v1.end());
+        v1.erase(v1.begin() + n, v1.end());
+
+        tail.push_back(11);
+        v_tail.push_back(11);
+        check_queue(tail, v_tail);
+        q1.push_back(13);
+        v1.push_back(13);
+        check_queue(q1, v1);
+    }
+
+    queue_t q_empty(min_history{&history});
+    history.clear();
+    q_empty.append(queue_t({3, 2, 4}));
+    ASSERT_TRUE(q_empty.min() == 2);
+    ASSERT_TRUE(history == std::vector<int>{2});
+    q_empty.append(queue_t());
+    ASSERT_TRUE(q_empty.size() == 3);
+}
+
+TEST(qwm2, append_split) {
+    test_append_split<true>();
+    test_append_split<false>();
+}
+
+TEST(qwm2, append_move_only) {
+    queue_with_min<std::unique_ptr<int> > q1;
+    queue_with_min<std::unique_ptr<int> > q2;
+    q1.push_back(nullptr);
+    q2.push_back(nullptr);
+    q2.push_back(nullptr);
+
+    q1.append(std::move(q2));
+    ASSERT_TRUE(q1.size() == 3);
+    ASSERT_TRUE(q2.empty());
+
+    queue_with_min<std::unique_ptr<int> > q3 = q1.split_at(1);
+    ASSERT_TRUE(q1.size() == 1);
+    ASSERT_TRUE(q3.size() == 2);
+}
+
+template <bool Flat>
+void test_segments_drain() {
+    typedef queue_with_min<int, min_history, Flat> queue_t;
+    std::vector<int> history;
+
+    queue_t q(min_history{&history});
+    std::deque<int> v;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(std::rand() % 100);
+        q.push_back(v.back());
+    }
+    q.pop_front();
+    v.pop_front();
+    q.push_back(50);
+    v.push_back(50);
+    q.push_back(-1);
+    v.push_back(-1);
+
+    std::vector<int> all;
+    const std::array<typename queue_t::segment_type, 2> segs = q.segments();
+    for (std::size_t i = 0; i < segs.size(); ++i) {
+        all.insert(all.end(), segs[i].begin(), segs[i].end());
+    }
+    ASSERT_TRUE(std::equal(all.begin(), all.end(), v.begin()));
+    ASSERT_TRUE(all.size() == v.size());
+
+    int out[4];
+    history.clear();
+    ASSERT_TRUE(q.drain(out, 4) == 4);
+    ASSERT_TRUE(std::equal(out, out + 4, v.begin()));
+    v.erase(v.begin(), v.begin() + 4);
+    ASSERT_TRUE(q.min() == -1);
+    ASSERT_TRUE(history.empty());
+
+    queue_t q2(q);
+    std::deque<int> v2 = v;
+    check_queue(q2, v2);
+
+    ASSERT_TRUE(q.drain(out, 4) == 4);
+    ASSERT_TRUE(std::equal(out, out + 4, v.begin()));
+    v.erase(v.begin(), v.begin() + 4);
+    ASSERT_TRUE(q.size() == 3);
+    ASSERT_TRUE(q.drain(out, 1) == 1);
+    ASSERT_TRUE(q.drain(out, 1) == 1);
+    ASSERT_TRUE(out[0] == 50);
+    ASSERT_TRUE(history.empty());
+
+    q.push_back(7);
+    ASSERT_TRUE(q.drain(out, 1) == 1);
+    ASSERT_TRUE(out[0] == -1);
+    ASSERT_TRUE(history == std::vector<int>{7});
+
+    all.clear();
+    std::size_t segments_count = 0;
+    q.push_back(8);
+    q.drain([&all, &segments_count](const typename queue_t::segment_type& seg) {
+        all.insert(all.end(), seg.begin(), seg.end());
+        ++segments_count;
+    });
+    ASSERT_TRUE((all == std::vector<int>{7, 8}));
+    ASSERT_TRUE(segments_count == 1); // ready part was drained
+    ASSERT_TRUE(q.empty());
+    ASSERT_TRUE(q.drain(out, 4) == 0);
+}
+
+TEST(qwm2, segments_drain) {
+    test_segments_drain<true>();
+    test_segments_drain<false>();
+
+    queue_with_min<std::unique_ptr<int> > q;
+    q.push_back(std::unique_ptr<int>(new int(1)));
+    q.push_back(std::unique_ptr<int>(new int(2)));
+    q.push_back(nullptr);
+
+    std::unique_ptr<int> out[2];
+    ASSERT_TRUE(q.drain(out, 2) == 2);
+    ASSERT_TRUE(*out[0] == 1);
+    ASSERT_TRUE(*out[1] == 2);
+    ASSERT_TRUE(q.size() == 1);
+}
+
+TEST(qwm2, memory_usage) {
+    const unsigned int values_count = 1000;
+
+    queue_with_min<unsigned int> q_flat;
+    queue_with_min<unsigned int, null_min_listener, false> q_list;
+    const std::size_t flat_empty = q_flat.memory_usage();
+    const std::size_t list_empty = q_list.memory_usage();
+
+    for (unsigned int i = 0; i < values_count; ++i) {
+        q_flat.push_back(i);
+        q_list.push_back(i);
+    }
+    q_flat.pop_front();
+    q_list.pop_front();
+
+    // increasing values: every element is a suffix minimum
+    ASSERT_TRUE(q_flat.memory_usage() >= flat_empty + (values_count - 1) * (sizeof(unsigned int) + sizeof(std::uint32_t)));
+    ASSERT_TRUE(q_list.memory_usage() >= list_empty + (values_count - 1) * (sizeof(unsigned int) + sizeof(void*)));
+    ASSERT_TRUE(q_flat.memory_usage() < q_list.memory_usage());
+
+    q_flat.clear();
+    ASSERT_TRUE(q_flat.memory_usage() >= flat_empty);
+    ASSERT_TRUE(queue_with_min<unsigned int>::max_size() == 0xFFFFFFFFu);
+}
+
+TEST(qwm2, storage_selection) {
+    ASSERT_TRUE( detail::use_flat_storage<int>::value );
+    ASSERT_TRUE( detail::use_flat_storage<double>::value );
+    ASSERT_FALSE( detail::use_flat_storage<std::unique_ptr<int> >::value );
+    ASSERT_FALSE( detail::use_flat_storage<bool>::value );
+    ASSERT_FALSE( detail::use_flat_storage<const bool>::value );
+}
+
+TEST(qwm2, bool_values) {
+    queue_with_min<bool> q;
+    q.push_back(true);
+    ASSERT_TRUE(q.min() == true);
+    q.push_back(false);
+    q.push_back(true);
+    ASSERT_TRUE(q.min() == false);
+    ASSERT_TRUE(q.size() == 3);
+
+    q.pop_front();
+    ASSERT_TRUE(q.min() == false);
+    q.pop_front();
+    ASSERT_TRUE(q.min() == true);
+    ASSERT_TRUE(q.front() == true);
+    q.pop_front();
+    ASSERT_TRUE(q.empty());
+}
+
+namespace {
+
+bool same_double(double lhs, double rhs) {
+    return (lhs != lhs && rhs != rhs) || lhs == rhs;
+}
+
+} // anonymous namespace
+
+TEST(qwm2, nan_values) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    queue_with_min<double> q;
+    q.push_back(nan);
+    ASSERT_TRUE(q.min() != q.min());
+    q.push_back(1.0);
+    ASSERT_TRUE(q.min() != q.min());
+    q.pop_front();
+    ASSERT_TRUE(q.min() == 1.0);
+
+    // contiguous storage gives the same elements as the std::list storage
+    for (int lazy = 0; lazy < 2; ++lazy) {
+        queue_with_min<double, null_min_listener, true> flat;
+        queue_with_min<double, null_min_listener, false> list;
+        if (lazy) {
+            flat.set_min_tracking(min_tracking::lazy);
+            list.set_min_tracking(min_tracking::lazy);
+        }
+
+        for (std::size_t i = 0; i < 5000; ++i) {
+            if (flat.empty() || std::rand() % 3) {
+                const double v = (std::rand() % 5 ? static_cast<double>(std::rand() % 100) : nan);
+                flat.push_back(v);
+                list.push_back(v);
+            } else {
+                flat.pop_front();
+                list.pop_front();
+            }
+
+            if (!flat.empty() && std::rand() % 2) {
+                ASSERT_TRUE(same_double(flat.min(), list.min()));
+            }
+        }
+    }
+}
+
+TEST(qwm2, flat_copies) {
+    queue_with_min<double> q({3.0, 1.0, 2.0, 0.5});
+    q.pop_front();
+    q.push_back(4.0);
+
+    queue_with_min<double> q_copy(q);
+    ASSERT_TRUE(q_copy == q);
+    ASSERT_TRUE(q_copy.min() == 0.5);
+    q_copy.pop_front();
+    q_copy.pop_front();
+    q_copy.pop_front();
+    ASSERT_TRUE(q_copy.min() == 4.0);
+
+    q_copy = q;
+    ASSERT_TRUE(q_copy == q);
+    q.clear();
+    ASSERT_TRUE(q.empty());
+    ASSERT_TRUE(q_copy.size() == 4);
+    q.push_back(-1.0);
+    ASSERT_TRUE(q.min() == -1.0);
+}
+
 
 TEST(qwm2, move_only) {
     queue_with_min<std::unique_ptr<int> > q;
@@ -163,6 +543,52 @@ TEST(qwm2, middle_states3) {
     ASSERT_TRUE(q.min() == 1);
 }
 
+template <bool Flat>
+void test_min_listener() {
+    std::vector<int> history;
+    queue_with_min<int, min_history, Flat> q(min_history{&history});
+
+    q.push_back(5);
+    q.push_back(7);
+    q.push_back(3);
+    q.push_back(3);
+    q.push_back(4);
+    ASSERT_TRUE((history == std::vector<int>{5, 3}));
+
+    q.pop_front(); // 5
+    q.pop_front(); // 7
+    ASSERT_TRUE((history == std::vector<int>{5, 3}));
+    q.push_back(1);
+    ASSERT_TRUE((history == std::vector<int>{5, 3, 1}));
+    q.pop_front(); // 3
+    q.pop_front(); // 3
+    q.pop_front(); // 4
+    ASSERT_TRUE((history == std::vector<int>{5, 3, 1}));
+    q.pop_front(); // 1
+    ASSERT_TRUE(q.empty());
+    ASSERT_TRUE((history == std::vector<int>{5, 3, 1}));
+
+    history.clear();
+    q = {4, 2, 6, 5};
+    q.pop_front(); // 4
+    ASSERT_TRUE(history.empty());
+    q.pop_front(); // 2
+    ASSERT_TRUE((history == std::vector<int>{5}));
+    q.push_back(5);
+    q.pop_front(); // 6
+    ASSERT_TRUE((history == std::vector<int>{5}));
+    q.pop_front(); // 5
+    ASSERT_TRUE((history == std::vector<int>{5}));
+    q.push_back(6);
+    q.pop_front(); // 5
+    ASSERT_TRUE((history == std::vector<int>{5, 6}));
+}
+
+TEST(qwm2, min_listener) {
+    test_min_listener<true>();
+    test_min_listener<false>();
+}
+
 
 TEST(qwm2, move_and_copy1) {
     queue_with_min<int> q({2, 1, 3, 4, 5});
@@ -256,9 +682,81 @@ TEST(qwm2, move_and_copy2) {
 
 }
 
+template <bool Flat>
+void test_move_swap() {
+    typedef queue_with_min<int, null_min_listener, Flat> queue_t;
+
+    for (int lazy = 0; lazy < 2; ++lazy) {
+        // ready and raw parts, only raw part, empty
+        queue_t q1({5, 2, 7, 1});
+        q1.pop_front();
+        q1.push_back(4);
+        q1.push_back(3);
+        queue_t q2({6, 8});
+        queue_t q3;
+        if (lazy) {
+            q1.set_min_tracking(min_tracking::lazy);
+            q2.set_min_tracking(min_tracking::lazy);
+            q1.push_back(9);
+            q2.push_back(0);
+        }
+
+        swap(q1, q3);
+        ASSERT_TRUE(q1.empty());
+        q1.push_back(10);
+        ASSERT_TRUE(q1.min() == 10);
+
+        q2.swap(q3);
+        std::deque<int> v2 = {2, 7, 1, 4, 3};
+        std::deque<int> v3 = {6, 8};
+        if (lazy) {
+            v2.push_back(9);
+            v3.push_back(0);
+        }
+
+        queue_t q4(std::move(q3));
+        ASSERT_TRUE(q3.empty());
+        q3.push_back(-1);
+        ASSERT_TRUE(q3.min() == -1);
+
+        q1 = std::move(q2);
+        ASSERT_TRUE(q2.empty());
+        q2.push_back(11);
+        ASSERT_TRUE(q2.min() == 11);
+
+        check_queue(q1, v2);
+        check_queue(q4, v3);
+    }
+
+    // container reallocations move the queues
+    std::vector<queue_t> queues;
+    for (int i = 0; i < 100; ++i) {
+        queues.push_back(queue_t({i + 2, i, i + 1}));
+        queues.back().pop_front();
+        queues.back().push_back(i + 3);
+    }
+    for (int i = 0; i < 100; ++i) {
+        std::deque<int> v = {i, i + 1, i + 3};
+        check_queue(queues[i], v);
+    }
+}
+
+TEST(qwm2, move_swap) {
+    test_move_swap<true>();
+    test_move_swap<false>();
+}
+
 TEST(qwm2, noexcepts) {
     ASSERT_TRUE( std::is_nothrow_constructible<queue_with_min<int> >() );
-    //ASSERT_TRUE( std::is_nothrow_move_assignable<queue_with_min<int> >() );
-    //ASSERT_TRUE( std::is_nothrow_move_constructible<queue_with_min<int> >() );
+    ASSERT_TRUE( std::is_nothrow_move_assignable<queue_with_min<int> >() );
+    ASSERT_TRUE( std::is_nothrow_move_constructible<queue_with_min<int> >() );
+    ASSERT_TRUE( noexcept(swap(std::declval<queue_with_min<int>&>(), std::declval<queue_with_min<int>&>())) );
+
+    typedef queue_with_min<int, null_min_listener, false> list_queue_t;
+    ASSERT_TRUE( std::is_nothrow_move_assignable<list_queue_t>() );
+    ASSERT_TRUE( std::is_nothrow_move_constructible<list_queue_t>() );
+    ASSERT_TRUE( noexcept(swap(std::declval<list_queue_t&>(), std::declval<list_queue_t&>())) );
+
+    ASSERT_TRUE( std::is_nothrow_move_constructible<queue_with_min<std::unique_ptr<int> > >() );
 }
 
@@ -0,0 +1,392 @@
+#ifndef EXAMPLES_TRACE_QUEUE_WITH_MIN_HPP
+#define EXAMPLES_TRACE_QUEUE_WITH_MIN_HPP
+
+#include <boost/config.hpp>
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace examples_v2 {
+
+/**
+Operations of a queue_with_min that are recorded to a trace.
+
+Trace format: 8 bytes of header {'Q', 'W', 'M', 'T', version, sizeof(T), trace_value_kind, 0}, then
+one byte of trace_op for each record. push_back records are followed by sizeof(T) bytes of the value
+in the native byte order.
+*/
+enum class trace_op: std::uint8_t {
+    push_back = 0,
+    pop_front = 1,
+    min = 2,
+    clear = 3
+};
+
+/// Count of the trace_op values.
+const std::size_t trace_ops_count = 4;
+
+/// Kind of the trace values, allows tools to replay traces of different types.
+enum class trace_value_kind: std::uint8_t {
+    signed_integer = 'i',
+    unsigned_integer = 'u',
+    floating_point = 'f',
+    other = 'o'
+};
+
+/// Type of the values in the trace, as stored in the trace header.
+struct trace_header {
+    std::uint8_t        value_size;
+    trace_value_kind    kind;
+};
+
+template <class T>
+struct trace_record {
+    trace_op    op;
+    T           value;  // valid only for trace_op::push_back
+};
+
+namespace detail {
+
+const char trace_magic[4] = {'Q', 'W', 'M', 'T'};
+const std::uint8_t trace_version = 1;
+
+template <class T>
+trace_value_kind trace_kind_of() noexcept {
+    return std::is_floating_point<T>::value ? trace_value_kind::floating_point
+        : std::is_integral<T>::value ? (std::is_signed<T>::value ? trace_value_kind::signed_integer : trace_value_kind::unsigned_integer)
+        : trace_value_kind::other;
+}
+
+} // namespace detail
+
+/// Writes the trace header and records to the stream. T must be trivially copyable.
+template <class T>
+class trace_writer {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static_assert(sizeof(T) < 256, "T is too big for a trace");
+
+    std::ostream& os_;
+
+public:
+    explicit trace_writer(std::ostream& os)
+        : os_(os)
+    {
+        const char header[8] = {
+            detail::trace_magic[0], detail::trace_magic[1], detail::trace_magic[2], detail::trace_magic[3],
+            static_cast<char>(detail::trace_version),
+            static_cast<char>(sizeof(T)),
+            static_cast<char>(detail::trace_kind_of<T>()),
+            0
+        };
+        os_.write(header, sizeof(header));
+    }
+
+    /// \b Complexity: O(1)
+    void write(trace_op op) {
+        os_.put(static_cast<char>(op));
+    }
+
+    /// \b Complexity: O(1)
+    void write_push_back(const T& v) {
+        char buf[1 + sizeof(T)];
+        buf[0] = static_cast<char>(trace_op::push_back);
+        std::memcpy(buf + 1, &v, sizeof(T));
+        os_.write(buf, sizeof(buf));
+    }
+};
+
+/// Reads the trace header. \throws std::runtime_error if the stream does not contain a trace.
+inline trace_header read_trace_header(std::istream& is) {
+    char header[8];
+    if (!is.read(header, sizeof(header))
+        || !std::equal(header, header + 4, detail::trace_magic)
+        || static_cast<std::uint8_t>(header[4]) != detail::trace_version)
+    {
+        throw std::runtime_error("examples_v2::read_trace_header: not a queue_with_min trace");
+    }
+
+    const trace_header res = { static_cast<std::uint8_t>(header[5]), static_cast<trace_value_kind>(header[6]) };
+    return res;
+}
+
+/**
+Reads the whole trace of T values.
+\throws std::runtime_error if the stream is not a trace of T, is truncated, or pops/reads min of an empty queue.
+
+\b Complexity: O(N)
+*/
+template <class T>
+std::vector<trace_record<T> > read_trace(std::istream& is) {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+    const trace_header h = read_trace_header(is);
+    if (h.value_size != sizeof(T) || h.kind != detail::trace_kind_of<T>()) {
+        throw std::runtime_error("examples_v2::read_trace: trace has values of other type");
+    }
+
+    std::vector<trace_record<T> > res;
+    std::size_t size = 0;
+    for (int c = is.get(); c != std::char_traits<char>::eof(); c = is.get()) {
+        trace_record<T> r = trace_record<T>();
+        r.op = static_cast<trace_op>(c);
+
+        switch (r.op) {
+        case trace_op::push_back: {
+            char buf[sizeof(T)];
+            if (!is.read(buf, sizeof(buf))) {
+                throw std::runtime_error("examples_v2::read_trace: truncated trace");
+            }
+            std::memcpy(&r.value, buf, sizeof(T));
+            ++ size;
+            break;
+        }
+
+        case trace_op::pop_front:
+        case trace_op::min:
+            if (!size) {
+                throw std::runtime_error("examples_v2::read_trace: operation on empty queue");
+            }
+            size -= (r.op == trace_op::pop_front);
+            break;
+
+        case trace_op::clear:
+            size = 0;
+            break;
+
+        default:
+            throw std::runtime_error("examples_v2::read_trace: unknown operation");
+        }
+
+        res.push_back(r);
+    }
+
+    return res;
+}
+
+/**
+Opt-in wrapper that records push_back, emplace_back, pop_front, min and clear calls of the Queue
+to a trace. Use it instead of the Queue to capture a real workload, the Queue itself is not affected.
+
+Queue::value_type must be trivially copyable.
+*/
+template <class Queue>
+class traced_queue_with_min {
+public:
+    typedef typename Queue::value_type value_type;
+
+private:
+    Queue                                   queue_;
+    mutable trace_writer<value_type>        trace_;
+
+public:
+    /// Writes the trace header to `os`. `os` must outlive *this.
+    explicit traced_queue_with_min(std::ostream& os)
+        : queue_()
+        , trace_(os)
+    {}
+
+    traced_queue_with_min(const traced_queue_with_min&) = delete;
+    traced_queue_with_min& operator=(const traced_queue_with_min&) = delete;
+
+    /// \b Complexity: same as for Queue::push_back()
+    void push_back(const value_type& v) {
+        queue_.push_back(v);
+        trace_.write_push_back(v);
+    }
+
+    /// \b Complexity: same as for Queue::emplace_back()
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        queue_.emplace_back(std::forward<Args>(args)...);
+        trace_.write_push_back(queue_.back());
+    }
+
+    /// \b Complexity: same as for Queue::pop_front()
+    void pop_front() {
+        queue_.pop_front();
+        trace_.write(trace_op::pop_front);
+    }
+
+    /// \b Complexity: same as for Queue::min()
+    const value_type& min() const {
+        const value_type& res = queue_.min();
+        trace_.write(trace_op::min);
+        return res;
+    }
+
+    /// \b Complexity: same as for Queue::clear()
+    void clear() {
+        queue_.clear();
+        trace_.write(trace_op::clear);
+    }
+
+    /// Not recorded. \b Complexity: O(1)
+    const value_type& front() const {
+        return queue_.front();
+    }
+
+    /// Not recorded. \b Complexity: O(1)
+    const value_type& back() const {
+        return queue_.back();
+    }
+
+    /// Not recorded. \b Complexity: O(1)
+    std::size_t size() const noexcept {
+        return queue_.size();
+    }
+
+    /// Not recorded. \b Complexity: O(1)
+    bool empty() const noexcept {
+        return queue_.empty();
+    }
+
+    /// Access to the wrapped queue, calls through it are not recorded.
+    const Queue& queue() const noexcept {
+        return queue_;
+    }
+};
+
+/**
+Latencies of one kind of operation, in nanoseconds. Each operation is timed by two steady_clock::now() calls,
+the median cost of two back to back now() calls (replay_result::timer_overhead_ns) is subtracted from each
+sample, negative results are clamped to 0. So the values are an estimate of the operation cost itself,
+with a precision limited by the clock resolution and the timer jitter.
+*/
+struct replay_op_stats {
+    std::size_t count;
+    double      mean_ns;
+    double      p50_ns;
+    double      p99_ns;
+    double      max_ns;
+};
+
+struct replay_result {
+    std::size_t     ops;
+    double          seconds;            // best time of the trace replay without per operation timers
+    double          ops_per_second;
+    double          timer_overhead_ns;  // subtracted from each per operation sample
+    replay_op_stats per_op[trace_ops_count];   // indexed by trace_op
+};
+
+namespace detail {
+
+// Median of the time between two back to back steady_clock::now() calls
+inline double timer_overhead_ns() {
+    typedef std::chrono::steady_clock clock_t;
+
+    std::vector<double> samples(10001);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        const clock_t::time_point start = clock_t::now();
+        const clock_t::time_point end = clock_t::now();
+        samples[i] = std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    std::vector<double>::iterator it = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), it, samples.end());
+    return *it;
+}
+
+template <class Queue, class T>
+inline void replay_one(Queue& q, const trace_record<T>& r, const T* volatile& sink) {
+    switch (r.op) {
+    case trace_op::push_back: q.push_back(r.value); break;
+    case trace_op::pop_front: q.pop_front(); break;
+    case trace_op::min: sink = &q.min(); break;
+    case trace_op::clear: q.clear(); break;
+    }
+}
+
+inline replay_op_stats make_replay_op_stats(std::vector<double>& samples) {
+    replay_op_stats res = replay_op_stats();
+    res.count = samples.size();
+    if (samples.empty()) {
+        return res;
+    }
+
+    double sum = 0;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        sum += samples[i];
+    }
+    res.mean_ns = sum / samples.size();
+
+    std::vector<double>::iterator it = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), it, samples.end());
+    res.p50_ns = *it;
+
+    it = samples.begin() + samples.size() * 99 / 100;
+    std::nth_element(samples.begin(), it, samples.end());
+    res.p99_ns = *it;
+
+    res.max_ns = *std::max_element(samples.begin(), samples.end());
+    return res;
+}
+
+} // namespace detail
+
+/**
+Replays the trace against a default constructed Queue `repeats` times and reports the best throughput.
+Then replays it once more timing each operation to get the latencies, see replay_op_stats.
+
+Works with any queue that has push_back(const T&), pop_front(), min() and clear().
+
+\b Complexity: O(N * repeats) operations of the Queue.
+*/
+template <class Queue>
+replay_result replay_trace(const std::vector<trace_record<typename Queue::value_type> >& trace, std::size_t repeats = 1) {
+    typedef typename Queue::value_type value_type;
+    typedef std::chrono::steady_clock clock_t;
+    typedef std::chrono::duration<double, std::nano> ns_t;
+
+    const value_type* volatile sink = 0;
+    replay_result res = replay_result();
+    res.ops = trace.size();
+
+    for (std::size_t i = 0; i < (std::max)(repeats, std::size_t(1)); ++i) {
+        Queue q;
+        const clock_t::time_point start = clock_t::now();
+        for (std::size_t j = 0; j < trace.size(); ++j) {
+            detail::replay_one(q, trace[j], sink);
+        }
+        const double seconds = std::chrono::duration<double>(clock_t::now() - start).count();
+
+        if (!i || seconds < res.seconds) {
+            res.seconds = seconds;
+        }
+    }
+    res.ops_per_second = (res.seconds > 0 ? res.ops / res.seconds : 0);
+
+    res.timer_overhead_ns = detail::timer_overhead_ns();
+
+    std::vector<double> samples[trace_ops_count];
+    Queue q;
+    for (std::size_t j = 0; j < trace.size(); ++j) {
+        const clock_t::time_point start = clock_t::now();
+        detail::replay_one(q, trace[j], sink);
+        const clock_t::time_point end = clock_t::now();
+
+        const double ns = ns_t(end - start).count() - res.timer_overhead_ns;
+        samples[static_cast<std::size_t>(trace[j].op)].push_back(ns > 0 ? ns : 0);
+    }
+
+    for (std::size_t i = 0; i < trace_ops_count; ++i) {
+        res.per_op[i] = detail::make_replay_op_stats(samples[i]);
+    }
+
+    return res;
+}
+
+} // namespace examples_v2
+
+#endif // EXAMPLES_TRACE_QUEUE_WITH_MIN_HPP
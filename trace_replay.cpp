@@ -0,0 +1,93 @@
+// Replays a trace recorded by examples_v2::traced_queue_with_min against all the queue_with_min implementations.
+//
+// Usage: trace_replay <trace file> [repeats]
+
+#include "trace_queue_with_min.hpp"
+#include "queue_with_min_v1.hpp"
+#include "queue_with_min_v2.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace examples_v2;
+
+namespace {
+
+const char* const op_names[trace_ops_count] = {"push_back", "pop_front", "min", "clear"};
+
+template <class Queue>
+void report(const char* name, const std::vector<trace_record<typename Queue::value_type> >& trace, std::size_t repeats) {
+    const replay_result r = replay_trace<Queue>(trace, repeats);
+
+    std::printf(
+        "%s: %zu ops in %.6f s, %.0f ops/s, timer overhead %.1f ns\n",
+        name, r.ops, r.seconds, r.ops_per_second, r.timer_overhead_ns
+    );
+    for (std::size_t i = 0; i < trace_ops_count; ++i) {
+        const replay_op_stats& s = r.per_op[i];
+        if (!s.count) {
+            continue;
+        }
+
+        std::printf(
+            "    %-10s %12zu ops, ns: mean %8.1f  p50 %8.1f  p99 %8.1f  max %10.1f\n",
+            op_names[i], s.count, s.mean_ns, s.p50_ns, s.p99_ns, s.max_ns
+        );
+    }
+}
+
+template <class T>
+void run(std::istream& is, std::size_t repeats) {
+    is.seekg(0);
+    const std::vector<trace_record<T> > trace = read_trace<T>(is);
+
+    report<examples_v1::queue_with_min<T> >("v1", trace, repeats);
+    report<examples_v2::queue_with_min<T, null_min_listener, false> >("v2 list", trace, repeats);
+    report<examples_v2::queue_with_min<T, null_min_listener, true> >("v2 flat", trace, repeats);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace file> [repeats]\n";
+        return 1;
+    }
+
+    std::ifstream is(argv[1], std::ios::binary);
+    if (!is) {
+        std::cerr << "Can not open " << argv[1] << '\n';
+        return 1;
+    }
+
+    const std::size_t repeats = (argc > 2 ? std::strtoul(argv[2], 0, 10) : 5);
+
+    try {
+        const trace_header h = read_trace_header(is);
+        switch (h.kind) {
+        case trace_value_kind::signed_integer:
+            if (h.value_size == 4) { run<std::int32_t>(is, repeats); return 0; }
+            if (h.value_size == 8) { run<std::int64_t>(is, repeats); return 0; }
+            break;
+        case trace_value_kind::unsigned_integer:
+            if (h.value_size == 4) { run<std::uint32_t>(is, repeats); return 0; }
+            if (h.value_size == 8) { run<std::uint64_t>(is, repeats); return 0; }
+            break;
+        case trace_value_kind::floating_point:
+            if (h.value_size == sizeof(float)) { run<float>(is, repeats); return 0; }
+            if (h.value_size == sizeof(double)) { run<double>(is, repeats); return 0; }
+            break;
+        default:
+            break;
+        }
+
+        std::cerr << "Unsupported value type of size " << static_cast<unsigned>(h.value_size) << '\n';
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+    }
+
+    return 1;
+}
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG -= console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXX = gcc
+QMAKE_CXXFLAGS += -std=c++0x -O2
+INCLUDEPATH += /home/antoshkka/boost_maintain/boost
+SOURCES += trace_replay.cpp trace_queue_with_min.hpp queue_with_min_v2.hpp queue_with_min_v1.hpp